@@ -11,6 +11,19 @@
 #include <stdexcept>
 #include "json.hpp"
 #include <barrier>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define BLOCK_FILE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 
 // ===================== Measurement =====================
@@ -20,12 +33,26 @@ public:
     long long start, end;
     bool correct;
     bool* iterative;
+    double verificationDuration = 0; // time spent in test_result, kept out of `duration`
+    bool verified = true;            // false when verification was skipped and `correct` is not meaningful
+    std::string error;               // why the run produced no result; empty when it ran
 
     Measurement(double threadCount, double duration, double dataSize, long long start, long long end, bool correct, bool* iterative = nullptr)
         : threadCount(threadCount), duration(duration), dataSize(dataSize), start(start), end(end), correct(correct), iterative(iterative) {}
 
     Measurement() = default;
 
+    // Stands in for a run that never produced a result, so it cannot be mistaken for a verified wrong one
+    static Measurement failed(const std::string& reason) {
+        Measurement measurement{};
+        measurement.verified = false;
+        measurement.error = reason;
+        return measurement;
+    }
+
+    // Algorithm-specific figures (nnz, pass counts, ...) reported next to the duration
+    nlohmann::json metrics = nlohmann::json::object();
+
     [[nodiscard]] std::string toString() const {
         if (iterative != nullptr) {
             return "Thread Count: " + std::to_string(threadCount) +
@@ -46,11 +73,19 @@ public:
         // j["start"] = start;
         // j["end"] = end;
         j["correct"] = correct;
+        j["verification_duration"] = verificationDuration;
+        j["verified"] = verified;
         if (iterative != nullptr) {
             j["iterative"] = *iterative;
         } else {
             j["iterative"] = false;
         }
+        if (!metrics.empty()) {
+            j["metrics"] = metrics;
+        }
+        if (!error.empty()) {
+            j["error"] = error;
+        }
         return j;
     }
 
@@ -66,10 +101,831 @@ public:
     Measurement &operator+=(const Measurement & result) {
         // add the values of the result to the current object
         duration += result.duration;
+        verificationDuration += result.verificationDuration;
         return *this;
     }
 };
 
+// ===================== SortingNetwork =====================
+// Bitonic sorting networks for blocks of 16..256 ints. The (k, j) comparator stages of each network size are
+// produced by a constexpr function and expanded into template instantiations, so every size is fully unrolled.
+enum class SimdLevel { Scalar, Avx2, Avx512 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx512: return "avx512";
+        case SimdLevel::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+enum class GapSequence { Ciura, Tokuda, Sedgewick };
+
+inline const char* gapSequenceName(GapSequence sequence) {
+    switch (sequence) {
+        case GapSequence::Tokuda: return "tokuda";
+        case GapSequence::Sedgewick: return "sedgewick";
+        default: return "ciura";
+    }
+}
+
+enum class KeyDistribution { Uniform, Skewed, NearlySorted, Runs };
+
+inline const char* keyDistributionName(KeyDistribution distribution) {
+    switch (distribution) {
+        case KeyDistribution::Skewed: return "skewed";
+        case KeyDistribution::NearlySorted: return "nearly_sorted";
+        case KeyDistribution::Runs: return "runs";
+        default: return "uniform";
+    }
+}
+
+// How BinarySearch runs a batch of lookups: one at a time, one at a time with the next probes prefetched,
+// or a group of lookups advanced round-robin so their cache misses overlap
+enum class LookupMode { Plain, Prefetch, Interleaved };
+
+inline const char* lookupModeName(LookupMode mode) {
+    switch (mode) {
+        case LookupMode::Plain: return "plain";
+        case LookupMode::Interleaved: return "interleaved";
+        default: return "prefetch";
+    }
+}
+
+struct BitonicNetwork {
+    static constexpr int minSize = 16;
+    static constexpr int maxSize = 256;
+
+    template <int N>
+    static constexpr auto stages() {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "bitonic networks need a power-of-two size");
+        constexpr int levels = std::bit_width(static_cast<unsigned>(N)) - 1;
+        std::array<std::pair<int, int>, levels * (levels + 1) / 2> list{};
+        int next = 0;
+        for (int k = 2; k <= N; k *= 2) {
+            for (int j = k / 2; j > 0; j /= 2) {
+                list[next++] = {k, j};
+            }
+        }
+        return list;
+    }
+
+    // Comparator between positions i and i ^ j in merge block k: does position i keep the smaller key?
+    static constexpr bool keepsMinimum(int index, int k, int j) {
+        return ((index & j) == 0) == ((index & k) == 0);
+    }
+
+    template <int N, int K, int J>
+    static void scalarStage(int* keys) {
+        for (int i = 0; i < N; ++i) {
+            int partner = i ^ J;
+            if (partner > i && (keys[i] > keys[partner]) == keepsMinimum(i, K, J)) {
+                std::swap(keys[i], keys[partner]);
+            }
+        }
+    }
+
+    template <int N, size_t... S>
+    static void scalarStages(int* keys, std::index_sequence<S...>) {
+        (scalarStage<N, stages<N>()[S].first, stages<N>()[S].second>(keys), ...);
+    }
+
+    template <int N>
+    static void sortScalar(int* keys) {
+        scalarStages<N>(keys, std::make_index_sequence<stages<N>().size()>());
+    }
+
+    // Merge whose loop body has no data-dependent branch: the comparison result advances one cursor or the other
+    static void mergeBranchless(const int* a, long long aCount, const int* b, long long bCount, int* output) {
+        long long i = 0, j = 0;
+        while (i < aCount && j < bCount) {
+            bool takeB = b[j] < a[i];
+            *output++ = takeB ? b[j] : a[i];
+            j += takeB;
+            i += !takeB;
+        }
+        output = std::copy(a + i, a + aCount, output);
+        std::copy(b + j, b + bCount, output);
+    }
+};
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITONIC_NETWORK_X86 1
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+// Eight keys per register: comparators more than a register apart are min/max of two registers,
+// closer ones permute the register against itself and blend the lanes that keep the minimum.
+struct BitonicNetworkAvx2 {
+    static constexpr int width = 8;
+
+    template <int K, int J>
+    static __m256i minimumLanes(int vector) {
+        alignas(32) int lanes[width];
+        for (int lane = 0; lane < width; ++lane) {
+            lanes[lane] = BitonicNetwork::keepsMinimum(vector * width + lane, K, J) ? -1 : 0;
+        }
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    }
+
+    template <int N, int K, int J>
+    static void stage(__m256i* v) {
+        if constexpr (J >= width) {
+            constexpr int stride = J / width;
+            for (int a = 0; a < N / width; ++a) {
+                if (a & stride) {
+                    continue;
+                }
+                __m256i low = _mm256_min_epi32(v[a], v[a | stride]);
+                __m256i high = _mm256_max_epi32(v[a], v[a | stride]);
+                bool ascending = ((a * width) & K) == 0;
+                v[a] = ascending ? low : high;
+                v[a | stride] = ascending ? high : low;
+            }
+        } else {
+            const __m256i partner = _mm256_setr_epi32(0 ^ J, 1 ^ J, 2 ^ J, 3 ^ J, 4 ^ J, 5 ^ J, 6 ^ J, 7 ^ J);
+            for (int a = 0; a < N / width; ++a) {
+                __m256i swapped = _mm256_permutevar8x32_epi32(v[a], partner);
+                __m256i low = _mm256_min_epi32(v[a], swapped);
+                __m256i high = _mm256_max_epi32(v[a], swapped);
+                v[a] = _mm256_blendv_epi8(high, low, minimumLanes<K, J>(a));
+            }
+        }
+    }
+
+    template <int N, size_t... S>
+    static void stages(__m256i* v, std::index_sequence<S...>) {
+        (stage<N, BitonicNetwork::stages<N>()[S].first, BitonicNetwork::stages<N>()[S].second>(v), ...);
+    }
+
+    template <int N>
+    static void sort(int* keys) {
+        __m256i v[N / width];
+        for (int a = 0; a < N / width; ++a) {
+            v[a] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + a * width));
+        }
+        stages<N>(v, std::make_index_sequence<BitonicNetwork::stages<N>().size()>());
+        for (int a = 0; a < N / width; ++a) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(keys + a * width), v[a]);
+        }
+    }
+
+    // Sorts the 16 keys of two ascending registers: afterwards low holds the smallest 8, high the largest 8
+    static void mergeRegisters(__m256i& low, __m256i& high) {
+        const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+        __m256i reversed = _mm256_permutevar8x32_epi32(high, reverse);
+        __m256i lower = _mm256_min_epi32(low, reversed);
+        __m256i upper = _mm256_max_epi32(low, reversed);
+        // Both halves are now bitonic; three half-cleaner stages sort each of them
+        low = cleanStage<1>(cleanStage<2>(cleanStage<4>(lower)));
+        high = cleanStage<1>(cleanStage<2>(cleanStage<4>(upper)));
+    }
+
+    template <int J>
+    static __m256i cleanStage(__m256i v) {
+        const __m256i partner = _mm256_setr_epi32(0 ^ J, 1 ^ J, 2 ^ J, 3 ^ J, 4 ^ J, 5 ^ J, 6 ^ J, 7 ^ J);
+        const __m256i lowerLanes = _mm256_setr_epi32((0 & J) ? 0 : -1, (1 & J) ? 0 : -1, (2 & J) ? 0 : -1, (3 & J) ? 0 : -1,
+                                                     (4 & J) ? 0 : -1, (5 & J) ? 0 : -1, (6 & J) ? 0 : -1, (7 & J) ? 0 : -1);
+        __m256i swapped = _mm256_permutevar8x32_epi32(v, partner);
+        return _mm256_blendv_epi8(_mm256_max_epi32(v, swapped), _mm256_min_epi32(v, swapped), lowerLanes);
+    }
+
+    // Streams two sorted runs through an 8+8 register merge network (Inoue et al.): the register holding the
+    // larger half is kept, and the next 8 keys come from whichever run has the smaller head.
+    static void merge(const int* a, long long aCount, const int* b, long long bCount, int* output) {
+        if (aCount < width || bCount < width) {
+            BitonicNetwork::mergeBranchless(a, aCount, b, bCount, output);
+            return;
+        }
+        const int* aEnd = a + aCount;
+        const int* bEnd = b + bCount;
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        a += width;
+        b += width;
+        while (true) {
+            mergeRegisters(low, high);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), low);
+            output += width;
+            bool fromA = b == bEnd || (a != aEnd && *a < *b);
+            const int*& source = fromA ? a : b;
+            if ((fromA ? aEnd : bEnd) - source < width) {
+                break;
+            }
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+            source += width;
+        }
+        // The 8 pending keys plus the short tail form one small run, merged with the other tail
+        alignas(32) int pending[width];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(pending), high);
+        int combined[2 * width];
+        bool aShort = aEnd - a < width;
+        const int* shortTail = aShort ? a : b;
+        long long shortCount = aShort ? aEnd - a : bEnd - b;
+        BitonicNetwork::mergeBranchless(pending, width, shortTail, shortCount, combined);
+        BitonicNetwork::mergeBranchless(combined, width + shortCount, aShort ? b : a, aShort ? bEnd - b : aEnd - a, output);
+    }
+};
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// Sixteen keys per register; lane selection uses mask registers instead of blend vectors.
+struct BitonicNetworkAvx512 {
+    static constexpr int width = 16;
+
+    template <int K, int J>
+    static __mmask16 minimumLanes(int vector) {
+        unsigned mask = 0;
+        for (int lane = 0; lane < width; ++lane) {
+            mask |= BitonicNetwork::keepsMinimum(vector * width + lane, K, J) ? 1u << lane : 0u;
+        }
+        return static_cast<__mmask16>(mask);
+    }
+
+    template <int N, int K, int J>
+    static void stage(__m512i* v) {
+        if constexpr (J >= width) {
+            constexpr int stride = J / width;
+            for (int a = 0; a < N / width; ++a) {
+                if (a & stride) {
+                    continue;
+                }
+                __m512i low = _mm512_min_epi32(v[a], v[a | stride]);
+                __m512i high = _mm512_max_epi32(v[a], v[a | stride]);
+                bool ascending = ((a * width) & K) == 0;
+                v[a] = ascending ? low : high;
+                v[a | stride] = ascending ? high : low;
+            }
+        } else {
+            const __m512i partner = _mm512_setr_epi32(0 ^ J, 1 ^ J, 2 ^ J, 3 ^ J, 4 ^ J, 5 ^ J, 6 ^ J, 7 ^ J,
+                                                      8 ^ J, 9 ^ J, 10 ^ J, 11 ^ J, 12 ^ J, 13 ^ J, 14 ^ J, 15 ^ J);
+            for (int a = 0; a < N / width; ++a) {
+                __m512i swapped = _mm512_permutexvar_epi32(partner, v[a]);
+                __m512i low = _mm512_min_epi32(v[a], swapped);
+                __m512i high = _mm512_max_epi32(v[a], swapped);
+                v[a] = _mm512_mask_blend_epi32(minimumLanes<K, J>(a), high, low);
+            }
+        }
+    }
+
+    template <int N, size_t... S>
+    static void stages(__m512i* v, std::index_sequence<S...>) {
+        (stage<N, BitonicNetwork::stages<N>()[S].first, BitonicNetwork::stages<N>()[S].second>(v), ...);
+    }
+
+    template <int N>
+    static void sort(int* keys) {
+        __m512i v[N / width];
+        for (int a = 0; a < N / width; ++a) {
+            v[a] = _mm512_loadu_si512(keys + a * width);
+        }
+        stages<N>(v, std::make_index_sequence<BitonicNetwork::stages<N>().size()>());
+        for (int a = 0; a < N / width; ++a) {
+            _mm512_storeu_si512(keys + a * width, v[a]);
+        }
+    }
+};
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+// Argmin over eight lanes: each lane keeps its running minimum and, through the compare mask,
+// the index where that minimum first appeared.
+struct ArgMinAvx2 {
+    // First index of the smallest key in keys[0, count); count must fit in an int
+    static long long find(const int* keys, long long count) {
+        long long vectorEnd = count & ~7LL;
+        long long best = 0;
+        if (vectorEnd > 0) {
+            __m256i minimum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+            __m256i minimumIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i index = minimumIndex;
+            const __m256i step = _mm256_set1_epi32(8);
+            for (long long i = 8; i < vectorEnd; i += 8) {
+                index = _mm256_add_epi32(index, step);
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                __m256i smaller = _mm256_cmpgt_epi32(minimum, v);
+                minimum = _mm256_min_epi32(minimum, v);
+                minimumIndex = _mm256_blendv_epi8(minimumIndex, index, smaller);
+            }
+            alignas(32) int values[8];
+            alignas(32) int indices[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values), minimum);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(indices), minimumIndex);
+            best = indices[0];
+            for (int lane = 1; lane < 8; ++lane) {
+                if (values[lane] < keys[best] || (values[lane] == keys[best] && indices[lane] < best)) {
+                    best = indices[lane];
+                }
+            }
+        }
+        for (long long i = vectorEnd; i < count; ++i) {
+            best = keys[i] < keys[best] ? i : best;
+        }
+        return best;
+    }
+};
+
+// Keys of a sorted 16-key S-tree node (64-byte aligned) that are below key: two compares and a popcount
+struct NodeRankAvx2 {
+    static int rank(const int* node, int key) {
+        const __m256i needle = _mm256_set1_epi32(key);
+        __m256i low = _mm256_cmpgt_epi32(needle, _mm256_load_si256(reinterpret_cast<const __m256i*>(node)));
+        __m256i high = _mm256_cmpgt_epi32(needle, _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8)));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(low))) |
+                    static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(high))) << 8;
+        return std::popcount(mask);
+    }
+};
+
+// Equality scan, four registers (two cache lines) per step; the compare masks are or-ed so the loop has a single branch.
+struct FindAvx2 {
+    // First index of key in keys[0, count), or -1
+    static long long find(const int* keys, long long count, int key) {
+        const __m256i needle = _mm256_set1_epi32(key);
+        long long i = 0;
+        for (; i + 32 <= count; i += 32) {
+            auto lanes = [&](int offset) {
+                return _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i + offset)), needle);
+            };
+            __m256i any = _mm256_or_si256(_mm256_or_si256(lanes(0), lanes(8)), _mm256_or_si256(lanes(16), lanes(24)));
+            if (!_mm256_testz_si256(any, any)) {
+                break; // the hit is somewhere in these 32 keys
+            }
+        }
+        for (; i < count; ++i) {
+            if (keys[i] == key) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+struct FindAvx512 {
+    // First index of key in keys[0, count), or -1; four registers (four cache lines) per step
+    static long long find(const int* keys, long long count, int key) {
+        const __m512i needle = _mm512_set1_epi32(key);
+        long long i = 0;
+        for (; i + 64 <= count; i += 64) {
+            auto lanes = [&](int offset) {
+                return static_cast<unsigned>(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(keys + i + offset), needle));
+            };
+            auto first = lanes(0) | lanes(16) << 16;
+            auto second = lanes(32) | lanes(48) << 16;
+            if ((first | second) != 0) {
+                return i + (first != 0 ? std::countr_zero(first) : 32 + std::countr_zero(second));
+            }
+        }
+        for (; i < count; ++i) {
+            if (keys[i] == key) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+#pragma GCC pop_options
+#endif
+
+// Best instruction set this CPU supports
+inline SimdLevel detectSimdLevel() {
+#ifdef BITONIC_NETWORK_X86
+    static const SimdLevel level = __builtin_cpu_supports("avx512f") ? SimdLevel::Avx512
+                                 : __builtin_cpu_supports("avx2") ? SimdLevel::Avx2
+                                 : SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// Sorts up to BitonicNetwork::maxSize keys: pads to the next network size with INT_MAX and runs that network
+inline void sortSmallBlock(int* keys, long long count, SimdLevel level) {
+    if (count <= 1) {
+        return;
+    }
+    alignas(64) int block[BitonicNetwork::maxSize];
+    int size = std::max<int>(BitonicNetwork::minSize, static_cast<int>(std::bit_ceil(static_cast<unsigned long long>(count))));
+    std::copy(keys, keys + count, block);
+    std::fill(block + count, block + size, INT_MAX);
+
+    auto run = [&]<int N>() {
+#ifdef BITONIC_NETWORK_X86
+        if (level == SimdLevel::Avx512) {
+            BitonicNetworkAvx512::sort<N>(block);
+            return;
+        }
+        if (level == SimdLevel::Avx2) {
+            BitonicNetworkAvx2::sort<N>(block);
+            return;
+        }
+#endif
+        BitonicNetwork::sortScalar<N>(block);
+    };
+    switch (size) {
+        case 16: run.template operator()<16>(); break;
+        case 32: run.template operator()<32>(); break;
+        case 64: run.template operator()<64>(); break;
+        case 128: run.template operator()<128>(); break;
+        default: run.template operator()<256>(); break;
+    }
+    std::copy(block, block + count, keys);
+}
+
+// Merges two sorted runs into output with the widest merge kernel allowed by level
+inline void mergeSortedRuns(const int* a, long long aCount, const int* b, long long bCount, int* output, SimdLevel level) {
+#ifdef BITONIC_NETWORK_X86
+    if (level != SimdLevel::Scalar) {
+        BitonicNetworkAvx2::merge(a, aCount, b, bCount, output);
+        return;
+    }
+#endif
+    BitonicNetwork::mergeBranchless(a, aCount, b, bCount, output);
+}
+
+// First index of the smallest key in keys[0, count), vectorized when level allows
+inline long long argMin(const int* keys, long long count, SimdLevel level) {
+#ifdef BITONIC_NETWORK_X86
+    if (level != SimdLevel::Scalar && count >= 16 && count <= INT_MAX) {
+        return ArgMinAvx2::find(keys, count);
+    }
+#endif
+    long long best = 0;
+    for (long long i = 1; i < count; ++i) {
+        best = keys[i] < keys[best] ? i : best;
+    }
+    return best;
+}
+
+// First index of key in keys[0, count), or -1, with the widest equality scan allowed by level
+inline long long findKey(const int* keys, long long count, int key, SimdLevel level) {
+#ifdef BITONIC_NETWORK_X86
+    if (level == SimdLevel::Avx512) {
+        return FindAvx512::find(keys, count, key);
+    }
+    if (level == SimdLevel::Avx2) {
+        return FindAvx2::find(keys, count, key);
+    }
+#endif
+    for (long long i = 0; i < count; ++i) {
+        if (keys[i] == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// ===================== ThreadPool =====================
+// Fixed set of workers owned by an Algorithm. A thread waiting on a TaskGroup runs queued tasks itself,
+// so tasks can fork and join nested work without starving the pool.
+class ThreadPool {
+public:
+    explicit ThreadPool(int workerCount) {
+        for (int i = 0; i < workerCount; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] int size() const {
+        return static_cast<int>(workers.size());
+    }
+
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+        ~TaskGroup() {
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!pool.runPendingTask()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void run(std::function<void()> task) {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.enqueue([this, task = std::move(task)]() {
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        // Helps with queued work until every task of this group has finished, then rethrows the first failure
+        void wait() {
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!pool.runPendingTask()) {
+                    std::this_thread::yield();
+                }
+            }
+            if (error) {
+                std::rethrow_exception(std::exchange(error, nullptr));
+            }
+        }
+
+    private:
+        ThreadPool& pool;
+        std::atomic<long long> pending{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    // Splits [begin, end) into `chunks` contiguous ranges (one per worker plus the caller by default)
+    // and calls body(chunk, chunkBegin, chunkEnd) for each; the calling thread takes the first range.
+    void parallelFor(long long begin, long long end, const std::function<void(int, long long, long long)>& body, int chunks = 0) {
+        if (chunks <= 0) {
+            chunks = size() + 1;
+        }
+        long long length = std::max(end - begin, 0LL);
+        chunks = static_cast<int>(std::max(1LL, std::min<long long>(chunks, length)));
+        auto bound = [&](int chunk) {
+            return begin + length / chunks * chunk + length % chunks * chunk / chunks;
+        };
+        TaskGroup group(*this);
+        for (int chunk = 1; chunk < chunks; ++chunk) {
+            group.run([&, chunk]() { body(chunk, bound(chunk), bound(chunk + 1)); });
+        }
+        body(0, bound(0), bound(1));
+        group.wait();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+
+    void enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(task));
+        }
+        queueReady.notify_one();
+    }
+
+    bool runPendingTask() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (queue.empty()) {
+                return false;
+            }
+            task = std::move(queue.back()); // newest first keeps a waiting fork close to its own children
+            queue.pop_back();
+        }
+        task();
+        return true;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (stopping && queue.empty()) {
+                    return;
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+// ===================== PeakRss =====================
+// High-water mark of the process's resident memory. reset() lowers the mark to the current RSS where the
+// kernel allows it (Linux 4.0+); otherwise bytes() keeps reporting the peak since the process started.
+struct PeakRss {
+    static bool reset() {
+#ifdef __linux__
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.flush();
+        return static_cast<bool>(clearRefs);
+#else
+        return false;
+#endif
+    }
+
+    // -1 where the platform does not report it
+    static long long bytes() {
+#ifdef __linux__
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            return static_cast<long long>(usage.ru_maxrss) * 1024; // reported in kilobytes
+        }
+#endif
+        return -1;
+    }
+};
+
+// ===================== Dataset =====================
+// Benchmark inputs saved with `dump` and replayed with `load`. Version 1 files are little-endian: a 64-byte
+// DatasetHeader, zero padding up to payloadOffset (a multiple of 4096), then rows * columns int32 values in row-major
+// order. The checksum depends on every value and its position, so truncated and reordered payloads are both caught.
+struct DatasetHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t elementType;
+    uint64_t count;
+    uint64_t rows;
+    uint64_t columns;
+    uint64_t checksum;
+    uint64_t payloadOffset;
+    uint64_t reserved;
+};
+static_assert(sizeof(DatasetHeader) == 64, "DatasetHeader is part of the file format");
+
+class Dataset {
+public:
+    static constexpr char magic[8] = {'A', 'L', 'G', 'B', 'E', 'N', 'C', 'H'};
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t int32Element = 1;
+    static constexpr uint64_t alignment = 4096;
+
+    // Maps the payload copy-on-write: algorithms that work in place never modify the file. Throws std::runtime_error
+    // if the file cannot be read or is not a version 1 int32 dataset.
+    explicit Dataset(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("Cannot read a dataset header from " + path.string());
+        }
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+            throw std::runtime_error(path.string() + " is not a dataset file");
+        }
+        if (header.version != version || header.elementType != int32Element) {
+            throw std::runtime_error(path.string() + " has dataset version " + std::to_string(header.version) +
+                                     " with element type " + std::to_string(header.elementType) + "; only version 1 int32 data is supported");
+        }
+        if (header.count != header.rows * header.columns || header.payloadOffset % alignment != 0 || header.payloadOffset < sizeof(header)) {
+            throw std::runtime_error(path.string() + " has an inconsistent dataset header");
+        }
+        std::error_code error;
+        auto fileBytes = std::filesystem::file_size(path, error);
+        if (error || fileBytes < header.payloadOffset + header.count * sizeof(int)) {
+            throw std::runtime_error(path.string() + " is shorter than its header says");
+        }
+        if (header.count == 0) {
+            return;
+        }
+#ifdef BLOCK_FILE_POSIX
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot open " + path.string() + ": " + std::strerror(errno));
+        }
+        mappedBytes = static_cast<size_t>(header.payloadOffset + header.count * sizeof(int));
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE; // map the pages for reading now rather than inside the timed region
+#endif
+        mapping = ::mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, flags, descriptor, 0);
+        int mapError = errno;
+        ::close(descriptor);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw std::runtime_error("Cannot map " + path.string() + ": " + std::strerror(mapError));
+        }
+        values = reinterpret_cast<int*>(static_cast<char*>(mapping) + header.payloadOffset);
+#else
+        buffer = std::make_unique<int[]>(header.count);
+        file.seekg(static_cast<std::streamoff>(header.payloadOffset));
+        if (!file.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(header.count * sizeof(int)))) {
+            throw std::runtime_error("Cannot read the payload of " + path.string());
+        }
+        values = buffer.get();
+#endif
+    }
+
+    ~Dataset() {
+#ifdef BLOCK_FILE_POSIX
+        if (mapping != nullptr) {
+            ::munmap(mapping, mappedBytes);
+        }
+#endif
+    }
+
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+
+    [[nodiscard]] int* data() const { return values; }
+    [[nodiscard]] long long count() const { return static_cast<long long>(header.count); }
+    [[nodiscard]] long long rows() const { return static_cast<long long>(header.rows); }
+    [[nodiscard]] long long columns() const { return static_cast<long long>(header.columns); }
+
+    [[nodiscard]] bool contains(const int* pointer) const {
+        return values != nullptr && pointer >= values && pointer < values + header.count;
+    }
+
+    // Recomputes the checksum; only meaningful before an algorithm has written to the mapping
+    [[nodiscard]] bool verify() const {
+        return checksum(values, count(), 0) == header.checksum;
+    }
+
+    // Saves `rows` arrays of `columns` ints each as one dataset
+    static void write(const std::filesystem::path& path, const std::vector<int*>& rows, long long columns) {
+        DatasetHeader header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.elementType = int32Element;
+        header.rows = rows.size();
+        header.columns = static_cast<uint64_t>(columns);
+        header.count = header.rows * header.columns;
+        header.payloadOffset = alignment;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            header.checksum += checksum(rows[r], columns, static_cast<long long>(r) * columns);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::vector<char> padding(header.payloadOffset - sizeof(header), 0);
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        for (const int* row : rows) {
+            file.write(reinterpret_cast<const char*>(row), static_cast<std::streamsize>(columns * sizeof(int)));
+        }
+        if (!file.flush()) {
+            throw std::runtime_error("Cannot write " + path.string());
+        }
+    }
+
+private:
+    DatasetHeader header{};
+    int* values = nullptr;
+#ifdef BLOCK_FILE_POSIX
+    void* mapping = nullptr;
+    size_t mappedBytes = 0;
+#else
+    std::unique_ptr<int[]> buffer;
+#endif
+
+    // Sum of a splitmix64 finalizer over (position, value) pairs; values[i] sits at position first + i
+    static uint64_t checksum(const int* values, long long count, long long first) {
+        uint64_t sum = 0;
+        for (long long i = 0; i < count; ++i) {
+            uint64_t z = (static_cast<uint64_t>(first + i) << 32 | static_cast<uint32_t>(values[i])) + 0x9e3779b97f4a7c15ULL;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            sum += z ^ (z >> 31);
+        }
+        return sum;
+    }
+};
+
+// ===================== AlgorithmOptions =====================
+// Tunables set from the command line (--name=value) or the REPL (set <name> <value>).
+struct AlgorithmOptions {
+    double sparseDensity = 0.01;     // fraction of non-zero entries in generated sparse matrices
+    double sparsePowerLaw = 0.0;     // row length skew; 0 gives uniform row lengths
+    int freivaldsRounds = 10;        // random vectors tried when verifying a matrix product (error <= 2^-rounds)
+    bool verifyResults = true;       // false skips test_result entirely for pure-throughput sweeps
+    int sortKeyMin = 0;              // generated sort keys lie in [sortKeyMin, sortKeyMax]
+    int sortKeyMax = 1000;
+    KeyDistribution keyDistribution = KeyDistribution::Uniform;
+    bool splitterPartition = false;  // sorts redistribute keys by value splitters before sorting instead of merging afterwards
+    bool inPlaceMerge = false;       // sorts merge slices in place (one block of scratch per thread) instead of into a second array
+    SimdLevel simdLevel = SimdLevel::Avx512; // widest vector kernels allowed; lowered to what the CPU supports
+    int heapArity = 2;               // children per HeapSort node: 2, 4 or 8
+    bool floydSift = true;           // HeapSort sifts down with Floyd's bottom-up method instead of the classic top-down one
+    GapSequence gapSequence = GapSequence::Ciura; // ShellSort gaps
+    int recordPayload = 16;          // payload bytes per record sort record: 8, 16, ..., 64
+    bool recordIndirect = false;     // record sorts order (key, index) pairs and gather the records once
+    long long externalMemoryMb = 256;  // ExternalSort working memory across all threads
+    std::string externalDirectory;   // where ExternalSort keeps its files; empty means the system temp directory
+    long long selectCount = 0;       // k for top-k and selection; 0 means selectFraction of the data size
+    double selectFraction = 0.01;
+    std::string datasetPath;         // inputs are taken from this dataset file instead of being generated; empty generates
+    long long queryCount = 0;        // BinarySearch lookups per run, spread over the threads; 0 searches one target
+    LookupMode lookupMode = LookupMode::Prefetch;
+};
+
 // ===================== Algorithm =====================
 class Algorithm {
 protected:
@@ -77,6 +933,8 @@ protected:
     long long dataSize;
     bool verbose = false;
     bool* reiterative;
+    AlgorithmOptions options;
+    nlohmann::json metrics = nlohmann::json::object();
 
 
 public:
@@ -85,6 +943,23 @@ public:
 
     virtual ~Algorithm() = default;
 
+    // Lazily started workers; with the calling thread helping, parallelFor runs on threadCount threads
+    ThreadPool& pool() {
+        if (!workerPool) {
+            workerPool = std::make_unique<ThreadPool>(std::max(threadCount - 1, 0));
+        }
+        return *workerPool;
+    }
+
+    // Whether the iterative implementation was requested (--use-iterative or the 'iterative' command)
+    [[nodiscard]] bool iterativeMode() const {
+        return reiterative != nullptr && *reiterative;
+    }
+
+    void setOptions(const AlgorithmOptions& algorithmOptions) {
+        options = algorithmOptions;
+    }
+
     std::vector<int*> executeTask(const std::vector<long long>& areaOfResponsibility, const std::vector<int*>& data,
         std::atomic<bool>& stopFlag, std::barrier<> & sync_point, int thread_id = 0) {
         if (verbose) {
@@ -94,7 +969,7 @@ public:
         if (verbose) {
             std::cout << "Thread " << thread_id << " starting execution." << std::endl;
         }
-        return execute(areaOfResponsibility, data, stopFlag);
+        return executeCooperative(areaOfResponsibility, data, stopFlag, sync_point, thread_id);
     }
 
     virtual void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const = 0;
@@ -108,7 +983,13 @@ public:
             std::cout << "Starting execution with " << threads << " threads and data size " << dataSize << "." << std::endl;
         }
 
+        metrics = nlohmann::json::object();
+        pool(); // start the workers before the clock so their creation is not measured
+        PeakRss::reset();
         std::vector<int*> data = generateData(dataSize);
+        if (options.verifyResults) {
+            prepare_test_result(data, dataSize);
+        }
         std::vector<std::thread> threadPool;
         std::vector<std::vector<int*>> result(threads);
         std::atomic<bool> stopFlag = false;
@@ -135,6 +1016,7 @@ public:
                         }
                     } catch (const std::exception& e) {
                         std::cerr << "Thread " << i << " encountered an exception: " << e.what() << std::endl;
+                        sync_point.arrive_and_drop(); // release threads waiting on this one in a cooperative phase
                     }
                 });
             }
@@ -148,8 +1030,12 @@ public:
             auto final_result = concat_results(result, data, threads, dataSize);
             auto end = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> duration = end - start;
+            long long peakRss = PeakRss::bytes();
+            metrics["peak_rss_bytes"] = peakRss >= 0 ? nlohmann::json(peakRss) : nlohmann::json(nullptr);
 
-            bool results_are_correct = test_result(data, final_result, dataSize);
+            auto verificationStart = std::chrono::high_resolution_clock::now();
+            bool results_are_correct = !options.verifyResults || test_result(data, final_result, dataSize);
+            std::chrono::duration<double> verificationDuration = std::chrono::high_resolution_clock::now() - verificationStart;
 
             if (verbose) {
                 std::cout << "Execution completed in " << duration.count() << " seconds. Results are "
@@ -158,7 +1044,7 @@ public:
 
             cleanupData(data, result);
 
-            return Measurement(
+            Measurement measurement(
                 static_cast<double>(threads),
                 duration.count(),
                 static_cast<double>(dataSize),
@@ -167,6 +1053,10 @@ public:
                 results_are_correct,
                 reiterative
             );
+            measurement.verificationDuration = verificationDuration.count();
+            measurement.verified = options.verifyResults;
+            measurement.metrics = metrics;
+            return measurement;
 
         } catch (const std::exception& e) {
             std::cerr << "Exception during execution: " << e.what() << std::endl;
@@ -179,278 +1069,3452 @@ public:
 
     virtual std::string getType() const = 0;
 
+    // Generates the input for dataSize and saves it as a dataset file that `load` can replay. Throws
+    // std::invalid_argument for algorithms whose input is not held in int arrays.
+    void dumpInput(long long dataSize, const std::filesystem::path& path) {
+        auto [rows, columns] = inputShape(dataSize);
+        std::vector<int*> data = generateData(dataSize);
+        std::vector<std::vector<int*>> noResult;
+        if (rows == 0 || static_cast<long long>(data.size()) != rows) {
+            cleanupData(data, noResult);
+            throw std::invalid_argument(getType() + " inputs cannot be dumped.");
+        }
+        try {
+            Dataset::write(path, data, columns);
+        } catch (const std::exception&) {
+            cleanupData(data, noResult);
+            throw;
+        }
+        cleanupData(data, noResult);
+    }
+
 protected:
     std::mutex outputMutex; // For synchronizing output
+    std::unique_ptr<ThreadPool> workerPool;
+    std::unique_ptr<Dataset> dataset; // mapped from options.datasetPath, replaced on every run
+
+    // Maps options.datasetPath and returns its first `count` values, which the algorithm may modify
+    // Callers that write their input in the timed region pass writable: every page is then written once here,
+    // untimed, so the copy-on-write faults and page copies are not charged to the algorithm. Readers keep the zero-copy mapping.
+    int* loadDataset(long long count, bool writable = false) {
+        dataset = std::make_unique<Dataset>(options.datasetPath);
+        if (dataset->count() < count) {
+            throw std::invalid_argument(options.datasetPath + " holds " + std::to_string(dataset->count()) +
+                                        " values, " + std::to_string(count) + " are needed.");
+        }
+        metrics["dataset"] = options.datasetPath;
+        int* values = dataset->data();
+        if (writable) {
+            constexpr long long pageInts = 4096 / sizeof(int);
+            pool().parallelFor(0, (count + pageInts - 1) / pageInts, [&](int, long long first, long long last) {
+                for (long long page = first; page < last; ++page) {
+                    auto* key = reinterpret_cast<volatile int*>(values + page * pageInts);
+                    *key = *key;
+                }
+            });
+        }
+        return values;
+    }
+
+    // cleanupData must not free arrays that point into the mapped dataset
+    [[nodiscard]] bool fromDataset(const int* pointer) const {
+        return dataset && dataset->contains(pointer);
+    }
+
+    // Rows and columns of the int arrays generateData returns, for dumpInput; {0, 0} if it returns something else
+    [[nodiscard]] virtual std::pair<long long, long long> inputShape(long long dataSize) const {
+        return {0, 0};
+    }
 
     virtual std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>& stopFlag) = 0;
+    // Worker thread entry point. Algorithms whose threads work in phases override it and synchronise on
+    // sync_point, which all worker threads share; by default each thread runs execute() on its own slice.
+    virtual std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData,
+        std::atomic<bool>& stopFlag, std::barrier<>& sync_point, int thread_id) {
+        return execute(area_of_responsibility, inputData, stopFlag);
+    }
     virtual std::vector<int*> generateData(long long dataSize) = 0;
     virtual std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) = 0;
     virtual bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) = 0;
+    // Untimed hook to capture whatever test_result needs from the input before the algorithm modifies it
+    virtual void prepare_test_result(const std::vector<int*>& input_data, long long dataSize) {}
     virtual std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) = 0;
 };
 
 
-// ===================== SortingAlgorithm =====================
-class SortingAlgorithm : public Algorithm {
+// ===================== LoserTree =====================
+// Tournament tree over k sorted int runs: each pop costs one leaf-to-root replay, O(log k) comparisons.
+// Exhausted runs carry a key above every int, so INT_MAX inputs still compare correctly.
+class LoserTree {
 public:
-    SortingAlgorithm(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : Algorithm(threadCount, dataSize, verbose, reiterative) {}
+    using Run = std::pair<const int*, const int*>;
 
-    [[nodiscard]] std::string getType() const override {
-        return "SortingAlgorithm";
+    explicit LoserTree(const std::vector<Run>& runs) : runs(runs) {
+        leaves = 1;
+        while (leaves < static_cast<int>(runs.size())) {
+            leaves *= 2;
+        }
+        keys.assign(leaves, exhausted);
+        for (size_t i = 0; i < runs.size(); ++i) {
+            keys[i] = headKey(static_cast<int>(i));
+        }
+        losers.assign(leaves, 0);
+        std::vector<int> winners(2 * leaves);
+        for (int i = 0; i < leaves; ++i) {
+            winners[leaves + i] = i;
+        }
+        for (int node = leaves - 1; node >= 1; --node) {
+            int left = winners[2 * node];
+            int right = winners[2 * node + 1];
+            bool leftWins = keys[left] <= keys[right];
+            winners[node] = leftWins ? left : right;
+            losers[node] = leftWins ? right : left;
+        }
+        losers[0] = winners[1];
     }
 
-protected:
-    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
-        if (!data.empty() && data[0] != nullptr) {
-            delete[] data[0]; // Deallocate the main array
-            data[0] = nullptr;
-        }
+    // Writes the next `count` smallest elements to output
+    void pop(int* output, long long count) {
+        for (long long produced = 0; produced < count; ++produced) {
+            int winner = losers[0];
+            output[produced] = *this->runs[winner].first++;
+            keys[winner] = headKey(winner);
+            for (int node = (winner + leaves) / 2; node > 0; node /= 2) {
+                if (keys[losers[node]] < keys[winner]) {
+                    std::swap(losers[node], winner);
+                }
+            }
+            losers[0] = winner;
+        }
+    }
+
+    // Merges the runs into output, which must hold the sum of their lengths
+    static void merge(const std::vector<Run>& runs, int* output) {
+        long long total = 0;
+        for (const auto& [first, last] : runs) {
+            total += last - first;
+        }
+        if (runs.size() == 1) {
+            std::copy(runs[0].first, runs[0].second, output);
+        } else if (runs.size() == 2) {
+            std::merge(runs[0].first, runs[0].second, runs[1].first, runs[1].second, output);
+        } else if (!runs.empty()) {
+            LoserTree(runs).pop(output, total);
+        }
+    }
+
+    // Multiway co-ranking: how many elements of each run precede output position `rank` in the merged order.
+    // Bisects on the key value, then hands out ties to runs in index order so splits are monotone in rank.
+    static std::vector<long long> coRank(const std::vector<Run>& runs, long long rank) {
+        long long low = INT_MIN;
+        long long high = INT_MAX;
+        while (low < high) {
+            long long middle = low + (high - low) / 2;
+            long long atMost = 0;
+            for (const auto& [first, last] : runs) {
+                atMost += std::upper_bound(first, last, static_cast<int>(middle)) - first;
+            }
+            if (atMost >= rank) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        auto pivot = static_cast<int>(low);
+        std::vector<long long> split(runs.size());
+        long long taken = 0;
+        for (size_t i = 0; i < runs.size(); ++i) {
+            split[i] = std::lower_bound(runs[i].first, runs[i].second, pivot) - runs[i].first;
+            taken += split[i];
+        }
+        for (size_t i = 0; i < runs.size() && taken < rank; ++i) {
+            long long equal = std::upper_bound(runs[i].first, runs[i].second, pivot) - runs[i].first - split[i];
+            long long extra = std::min(equal, rank - taken);
+            split[i] += extra;
+            taken += extra;
+        }
+        return split;
+    }
+
+private:
+    static constexpr long long exhausted = LLONG_MAX;
+    std::vector<Run> runs;
+    std::vector<long long> keys;
+    std::vector<int> losers; // losers[0] holds the overall winner
+    int leaves;
+
+    long long headKey(int run) const {
+        return runs[run].first < runs[run].second ? *runs[run].first : exhausted;
+    }
+};
+
+// ===================== InPlaceMerge =====================
+// Merges adjacent sorted ranges [first, middle) and [middle, last) without a full-size buffer. The longer run is cut at
+// its midpoint, the matching cut in the other run is found by binary search, and rotating the middle leaves two
+// independent smaller merges. Once the shorter run fits in blockSize keys it is merged through a per-thread buffer,
+// so extra memory is one block per thread.
+struct InPlaceMerge {
+    static constexpr long long blockSize = 1 << 12;
+
+    static bool ordered(const int* first, const int* middle, const int* last) {
+        return first == middle || middle == last || middle[-1] <= *middle;
+    }
+
+    // Cut points {cut1 in the left run, cut2 in the right run}; after rotate(cut1, middle, cut2) everything before the
+    // new middle is <= everything after it, and equal keys keep their order
+    static std::pair<int*, int*> cuts(int* first, int* middle, int* last) {
+        if (middle - first >= last - middle) {
+            int* cut1 = first + (middle - first) / 2;
+            return {cut1, std::lower_bound(middle, last, *cut1)};
+        }
+        int* cut2 = middle + (last - middle) / 2;
+        return {std::upper_bound(first, middle, *cut2), cut2};
+    }
+
+    // Copies the shorter run (at most blockSize keys) aside and merges towards the end it vacated
+    static void bufferedMerge(int* first, int* middle, int* last) {
+        thread_local std::unique_ptr<int[]> buffer(new int[blockSize]);
+        int* aside = buffer.get();
+        if (middle - first <= last - middle) {
+            int* asideEnd = std::copy(first, middle, aside);
+            int* out = first;
+            while (aside < asideEnd && middle < last) {
+                *out++ = *middle < *aside ? *middle++ : *aside++;
+            }
+            std::copy(aside, asideEnd, out);
+        } else {
+            int* asideEnd = std::copy(middle, last, aside);
+            int* out = last;
+            while (first < middle && aside < asideEnd) {
+                *--out = asideEnd[-1] < middle[-1] ? *--middle : *--asideEnd;
+            }
+            std::copy_backward(aside, asideEnd, out);
+        }
+    }
+
+    static void merge(int* first, int* middle, int* last) {
+        while (!ordered(first, middle, last)) {
+            if (std::min(middle - first, last - middle) <= blockSize) {
+                bufferedMerge(first, middle, last);
+                return;
+            }
+            auto [cut1, cut2] = cuts(first, middle, last);
+            int* newMiddle = std::rotate(cut1, middle, cut2);
+            // Recurse into the smaller half and loop on the larger one to bound the stack depth
+            if (newMiddle - first < last - newMiddle) {
+                merge(first, cut1, newMiddle);
+                first = newMiddle;
+                middle = cut2;
+            } else {
+                merge(newMiddle, cut2, last);
+                last = newMiddle;
+                middle = cut1;
+            }
+        }
+    }
+};
+
+// ===================== PdqSortKernel =====================
+// Pattern-defeating quicksort for ints: ninther pivots, BlockQuicksort-style branchless partitioning (misplaced
+// keys are recorded as byte offsets in 64-key blocks, then swapped), a partition-left pass for runs of equal keys,
+// partial insertion sort to finish already-partitioned ranges, pattern-breaking swaps after unbalanced splits,
+// and heapsort once too many unbalanced splits have been seen.
+struct PdqSortKernel {
+    static constexpr long long insertionSortThreshold = 24;
+    static constexpr long long nintherThreshold = 128;
+    static constexpr long long partialInsertionSortLimit = 8;
+    static constexpr int blockSize = 64;
+
+    static void sort(int* first, int* last) {
+        if (last - first > 1) {
+            loop(first, last, std::bit_width(static_cast<unsigned long long>(last - first)), true);
+        }
+    }
+
+    static void insertionSort(int* first, int* last) {
+        if (first == last) {
+            return;
+        }
+        for (int* current = first + 1; current != last; ++current) {
+            int* sift = current;
+            if (*sift < *(sift - 1)) {
+                int key = *sift;
+                do {
+                    *sift = *(sift - 1);
+                    --sift;
+                } while (sift != first && key < *(sift - 1));
+                *sift = key;
+            }
+        }
+    }
+
+    // Insertion sort that relies on a key no larger than everything in the range sitting just before `first`
+    static void unguardedInsertionSort(int* first, int* last) {
+        if (first == last) {
+            return;
+        }
+        for (int* current = first + 1; current != last; ++current) {
+            int* sift = current;
+            if (*sift < *(sift - 1)) {
+                int key = *sift;
+                do {
+                    *sift = *(sift - 1);
+                    --sift;
+                } while (key < *(sift - 1));
+                *sift = key;
+            }
+        }
+    }
+
+    // Insertion sort that gives up after moving a handful of keys; true if the range ended up sorted
+    static bool partialInsertionSort(int* first, int* last) {
+        if (first == last) {
+            return true;
+        }
+        long long moved = 0;
+        for (int* current = first + 1; current != last; ++current) {
+            int* sift = current;
+            if (*sift < *(sift - 1)) {
+                int key = *sift;
+                do {
+                    *sift = *(sift - 1);
+                    --sift;
+                } while (sift != first && key < *(sift - 1));
+                *sift = key;
+                moved += current - sift;
+            }
+            if (moved > partialInsertionSortLimit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void sort2(int* a, int* b) {
+        if (*b < *a) {
+            std::swap(*a, *b);
+        }
+    }
+
+    static void sort3(int* a, int* b, int* c) {
+        sort2(a, b);
+        sort2(b, c);
+        sort2(a, b);
+    }
+
+    static void swapOffsets(int* leftBase, int* rightBase, const unsigned char* leftOffsets, const unsigned char* rightOffsets, long long count, bool useSwaps) {
+        if (useSwaps) {
+            // Equal counts on both sides: plain swaps keep the pattern symmetric
+            for (long long i = 0; i < count; ++i) {
+                std::swap(leftBase[leftOffsets[i]], *(rightBase - rightOffsets[i]));
+            }
+        } else if (count > 0) {
+            // Cyclic permutation: one temporary and two moves per key instead of three
+            int* left = leftBase + leftOffsets[0];
+            int* right = rightBase - rightOffsets[0];
+            int temporary = *left;
+            *left = *right;
+            for (long long i = 1; i < count; ++i) {
+                left = leftBase + leftOffsets[i];
+                *right = *left;
+                right = rightBase - rightOffsets[i];
+                *left = *right;
+            }
+            *right = temporary;
+        }
+    }
+
+    // Partitions around *first: keys < pivot to its left, keys >= pivot to its right. Returns the pivot's final
+    // position and whether the range was already partitioned (no swaps were needed).
+    static std::pair<int*, bool> partitionRightBranchless(int* begin, int* end) {
+        int pivot = *begin;
+        int* first = begin;
+        int* last = end;
+        while (*++first < pivot) {}
+        if (first - 1 == begin) {
+            while (first < last && !(*--last < pivot)) {}
+        } else {
+            while (!(*--last < pivot)) {}
+        }
+        bool alreadyPartitioned = first >= last;
+        if (!alreadyPartitioned) {
+            std::swap(*first, *last);
+            ++first;
+
+            alignas(64) unsigned char leftOffsetStorage[blockSize];
+            alignas(64) unsigned char rightOffsetStorage[blockSize];
+            unsigned char* leftOffsets = leftOffsetStorage;
+            unsigned char* rightOffsets = rightOffsetStorage;
+            int* leftBase = first;
+            int* rightBase = last;
+            long long leftCount = 0, rightCount = 0, leftStart = 0, rightStart = 0;
+            while (first < last) {
+                long long unknown = last - first;
+                long long leftSplit = leftCount == 0 ? (rightCount == 0 ? unknown / 2 : unknown) : 0;
+                long long rightSplit = rightCount == 0 ? unknown - leftSplit : 0;
+
+                // The offset is always written; the count only advances for a misplaced key, so there is no branch
+                for (long long i = 0, n = std::min<long long>(leftSplit, blockSize); i < n; ++i) {
+                    leftOffsets[leftCount] = static_cast<unsigned char>(i);
+                    leftCount += !(*first < pivot);
+                    ++first;
+                }
+                for (long long i = 0, n = std::min<long long>(rightSplit, blockSize); i < n;) {
+                    rightOffsets[rightCount] = static_cast<unsigned char>(++i);
+                    rightCount += *--last < pivot;
+                }
+
+                long long count = std::min(leftCount, rightCount);
+                swapOffsets(leftBase, rightBase, leftOffsets + leftStart, rightOffsets + rightStart, count, leftCount == rightCount);
+                leftCount -= count;
+                rightCount -= count;
+                leftStart += count;
+                rightStart += count;
+                if (leftCount == 0) {
+                    leftStart = 0;
+                    leftBase = first;
+                }
+                if (rightCount == 0) {
+                    rightStart = 0;
+                    rightBase = last;
+                }
+            }
+
+            // One side may still hold misplaced keys; move them next to the boundary
+            if (leftCount) {
+                leftOffsets += leftStart;
+                while (leftCount--) {
+                    std::swap(leftBase[leftOffsets[leftCount]], *--last);
+                }
+                first = last;
+            }
+            if (rightCount) {
+                rightOffsets += rightStart;
+                while (rightCount--) {
+                    std::swap(*(rightBase - rightOffsets[rightCount]), *first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+        int* pivotPosition = first - 1;
+        *begin = *pivotPosition;
+        *pivotPosition = pivot;
+        return {pivotPosition, alreadyPartitioned};
+    }
+
+    // Keys equal to the pivot go left; used when the pivot equals the key just before the range,
+    // so the whole left side is equal keys and needs no further sorting
+    static int* partitionLeft(int* begin, int* end) {
+        int pivot = *begin;
+        int* first = begin;
+        int* last = end;
+        while (pivot < *--last) {}
+        if (last + 1 == end) {
+            while (first < last && !(pivot < *++first)) {}
+        } else {
+            while (!(pivot < *++first)) {}
+        }
+        while (first < last) {
+            std::swap(*first, *last);
+            while (pivot < *--last) {}
+            while (!(pivot < *++first)) {}
+        }
+        *begin = *last;
+        *last = pivot;
+        return last;
+    }
+
+    static void loop(int* begin, int* end, int badAllowed, bool leftmost) {
+        while (true) {
+            long long size = end - begin;
+            if (size < insertionSortThreshold) {
+                if (leftmost) {
+                    insertionSort(begin, end);
+                } else {
+                    unguardedInsertionSort(begin, end);
+                }
+                return;
+            }
+
+            long long half = size / 2;
+            if (size > nintherThreshold) {
+                sort3(begin, begin + half, end - 1);
+                sort3(begin + 1, begin + (half - 1), end - 2);
+                sort3(begin + 2, begin + (half + 1), end - 3);
+                sort3(begin + (half - 1), begin + half, begin + (half + 1));
+                std::swap(*begin, *(begin + half));
+            } else {
+                sort3(begin + half, begin, end - 1);
+            }
+
+            if (!leftmost && !(*(begin - 1) < *begin)) {
+                begin = partitionLeft(begin, end) + 1;
+                continue;
+            }
+
+            auto [pivotPosition, alreadyPartitioned] = partitionRightBranchless(begin, end);
+            long long leftSize = pivotPosition - begin;
+            long long rightSize = end - (pivotPosition + 1);
+            bool highlyUnbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+            if (highlyUnbalanced) {
+                if (--badAllowed == 0) {
+                    std::make_heap(begin, end);
+                    std::sort_heap(begin, end);
+                    return;
+                }
+                // Swap a few keys into new places to break patterns that keep producing bad pivots
+                if (leftSize >= insertionSortThreshold) {
+                    std::swap(*begin, *(begin + leftSize / 4));
+                    std::swap(*(pivotPosition - 1), *(pivotPosition - leftSize / 4));
+                    if (leftSize > nintherThreshold) {
+                        std::swap(*(begin + 1), *(begin + (leftSize / 4 + 1)));
+                        std::swap(*(begin + 2), *(begin + (leftSize / 4 + 2)));
+                        std::swap(*(pivotPosition - 2), *(pivotPosition - (leftSize / 4 + 1)));
+                        std::swap(*(pivotPosition - 3), *(pivotPosition - (leftSize / 4 + 2)));
+                    }
+                }
+                if (rightSize >= insertionSortThreshold) {
+                    std::swap(*(pivotPosition + 1), *(pivotPosition + (1 + rightSize / 4)));
+                    std::swap(*(end - 1), *(end - rightSize / 4));
+                    if (rightSize > nintherThreshold) {
+                        std::swap(*(pivotPosition + 2), *(pivotPosition + (2 + rightSize / 4)));
+                        std::swap(*(pivotPosition + 3), *(pivotPosition + (3 + rightSize / 4)));
+                        std::swap(*(end - 2), *(end - (1 + rightSize / 4)));
+                        std::swap(*(end - 3), *(end - (2 + rightSize / 4)));
+                    }
+                }
+            } else if (alreadyPartitioned && partialInsertionSort(begin, pivotPosition) && partialInsertionSort(pivotPosition + 1, end)) {
+                return;
+            }
+
+            loop(begin, pivotPosition, badAllowed, leftmost);
+            begin = pivotPosition + 1;
+            leftmost = false;
+        }
+    }
+};
+
+// ===================== BranchMissCounter =====================
+// Hardware branch-miss counter for the calling thread (Linux perf events, user space only).
+// read() returns -1 where the counter cannot be opened, e.g. without a PMU or on other platforms.
+class BranchMissCounter {
+public:
+    BranchMissCounter() {
+#ifdef __linux__
+        perf_event_attr attributes{};
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+
+    ~BranchMissCounter() {
+#ifdef __linux__
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+#endif
+    }
+
+    BranchMissCounter(const BranchMissCounter&) = delete;
+    BranchMissCounter& operator=(const BranchMissCounter&) = delete;
+
+    [[nodiscard]] long long read() const {
+#ifdef __linux__
+        long long count = 0;
+        if (descriptor >= 0 && ::read(descriptor, &count, sizeof(count)) == sizeof(count)) {
+            return count;
+        }
+#endif
+        return -1;
+    }
+
+private:
+    int descriptor = -1;
+};
+
+// ===================== BlockFile =====================
+// Positional reads and writes of int blocks, safe to issue from several threads at once. POSIX builds use
+// pread/pwrite on one descriptor; elsewhere a mutex-guarded std::fstream stands in.
+class BlockFile {
+public:
+    explicit BlockFile(const std::filesystem::path& path) : path(path) {
+#ifdef BLOCK_FILE_POSIX
+        descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot create " + path.string() + ": " + std::strerror(errno));
+        }
+#else
+        stream.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("Cannot create " + path.string());
+        }
+#endif
+    }
+
+    ~BlockFile() {
+#ifdef BLOCK_FILE_POSIX
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+#else
+        stream.close();
+#endif
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+
+    BlockFile(const BlockFile&) = delete;
+    BlockFile& operator=(const BlockFile&) = delete;
+
+    // count keys starting at key index `position`
+    void read(int* keys, long long count, long long position) {
+        transfer(keys, count, position, false);
+    }
+
+    void write(const int* keys, long long count, long long position) {
+        transfer(const_cast<int*>(keys), count, position, true);
+    }
+
+private:
+    std::filesystem::path path;
+#ifdef BLOCK_FILE_POSIX
+    int descriptor = -1;
+#else
+    std::fstream stream;
+    std::mutex streamMutex;
+#endif
+
+    void transfer(int* keys, long long count, long long position, bool writing) {
+        auto* bytes = reinterpret_cast<char*>(keys);
+        auto remaining = static_cast<size_t>(count) * sizeof(int);
+        auto offset = static_cast<long long>(position * sizeof(int));
+#ifdef BLOCK_FILE_POSIX
+        while (remaining > 0) {
+            ssize_t done = writing ? ::pwrite(descriptor, bytes, remaining, offset) : ::pread(descriptor, bytes, remaining, offset);
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            if (done <= 0) {
+                throw std::runtime_error((writing ? "Write to " : "Read from ") + path.string() + " failed: " + std::strerror(errno));
+            }
+            bytes += done;
+            remaining -= static_cast<size_t>(done);
+            offset += done;
+        }
+#else
+        std::lock_guard<std::mutex> lock(streamMutex);
+        if (writing) {
+            stream.seekp(offset);
+            stream.write(bytes, static_cast<std::streamsize>(remaining));
+        } else {
+            stream.seekg(offset);
+            stream.read(bytes, static_cast<std::streamsize>(remaining));
+        }
+        if (!stream) {
+            throw std::runtime_error((writing ? "Write to " : "Read from ") + path.string() + " failed");
+        }
+#endif
+    }
+};
+
+// ===================== SortingAlgorithm =====================
+class SortingAlgorithm : public Algorithm {
+public:
+    SortingAlgorithm(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : Algorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SortingAlgorithm";
+    }
+
+protected:
+    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
+        if (!data.empty() && data[0] != nullptr) {
+            if (!fromDataset(data[0])) {
+                delete[] data[0]; // Deallocate the main array
+            }
+            data[0] = nullptr;
+        }
+
+        for (auto& partial_result : result) {
+            if (!partial_result.empty() && partial_result[0] != nullptr) {
+                delete[] partial_result[0]; // Deallocate each partial result
+                partial_result[0] = nullptr;
+            }
+        }
+
+        result.clear();
+        data.clear();
+    }
+
+    std::unique_ptr<int[]> mergedData;
+    std::atomic<long long> branchMisses = 0;      // summed over the sortSegment calls of all threads
+    std::atomic<bool> branchMissesCounted = true; // false once any thread could not open its counter
+
+    // The per-thread sorted runs are merged with a loser tree. The output is cut into one slice per pool
+    // thread and co-ranking finds where each slice starts inside every run, so the slices merge independently.
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        recordBranchMisses();
+        if (options.splitterPartition) {
+            recordBucketImbalance(thread_count, data_size);
+            return {partition.buffer.get()}; // buckets are already in value order, nothing to merge
+        }
+        if (verbose) {
+            std::cout << "Merging partial results from threads." << std::endl;
+        }
+        metrics["merge"] = options.inPlaceMerge ? "in_place" : "buffered";
+        if (options.inPlaceMerge) {
+            mergeSlicesInPlace(inputData[0], thread_count, data_size);
+            return {inputData[0]};
+        }
+
+        mergedData.reset(new int[data_size]);
+        std::vector<LoserTree::Run> runs(thread_count);
+        for (int i = 0; i < thread_count; ++i) {
+            auto area_of_responsibility = calculate_area_of_responsibility(i, thread_count, data_size);
+            runs[i] = {inputData[0] + area_of_responsibility[0], inputData[0] + area_of_responsibility[1]};
+        }
+        mergeRunsParallel(runs, data_size, mergedData.get());
+
+        if (verbose) {
+            std::cout << "Merged data successfully." << std::endl;
+        }
+
+        return {mergedData.get()}; // Owned by mergedData, released with the algorithm
+    }
+
+    // Loser-tree merge of sorted runs holding `total` keys, cut into one output slice per pool thread
+    void mergeRunsParallel(const std::vector<LoserTree::Run>& runs, long long total, int* output) {
+        int slices = pool().size() + 1;
+        pool().parallelFor(0, slices, [&](int, long long first, long long last) {
+            for (long long slice = first; slice < last; ++slice) {
+                long long rank = total / slices * slice + total % slices * slice / slices;
+                auto from = LoserTree::coRank(runs, rank);
+                auto to = LoserTree::coRank(runs, total / slices * (slice + 1) + total % slices * (slice + 1) / slices);
+                std::vector<LoserTree::Run> sliceRuns;
+                for (size_t i = 0; i < runs.size(); ++i) {
+                    if (from[i] < to[i]) {
+                        sliceRuns.emplace_back(runs[i].first + from[i], runs[i].first + to[i]);
+                    }
+                }
+                LoserTree::merge(sliceRuns, output + rank);
+            }
+        }, slices);
+    }
+
+    static constexpr long long parallelMergeGrain = 1 << 16;
+
+    // Pairwise merge tree over the sorted slices; each level's merges run as tasks and split further themselves
+    void mergeSlicesInPlace(int* data, int thread_count, long long data_size) {
+        std::vector<long long> bounds;
+        for (int i = 0; i < thread_count; ++i) {
+            bounds.push_back(calculate_area_of_responsibility(i, thread_count, data_size)[0]);
+        }
+        bounds.push_back(data_size);
+        while (bounds.size() > 2) {
+            std::vector<long long> next;
+            ThreadPool::TaskGroup group(pool());
+            for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                next.push_back(bounds[i]);
+                if (i + 2 < bounds.size()) {
+                    group.run([=, this]() { mergeInPlace(data + bounds[i], data + bounds[i + 1], data + bounds[i + 2]); });
+                }
+            }
+            next.push_back(data_size);
+            group.wait();
+            bounds = std::move(next);
+        }
+    }
+
+    // InPlaceMerge with the rotation done as three parallel reversals and the two halves merged as separate tasks
+    void mergeInPlace(int* first, int* middle, int* last) {
+        if (last - first <= parallelMergeGrain) {
+            InPlaceMerge::merge(first, middle, last);
+            return;
+        }
+        if (InPlaceMerge::ordered(first, middle, last)) {
+            return;
+        }
+        auto [cut1, cut2] = InPlaceMerge::cuts(first, middle, last);
+        reverseParallel(cut1, middle);
+        reverseParallel(middle, cut2);
+        reverseParallel(cut1, cut2);
+        int* newMiddle = cut1 + (cut2 - middle);
+        ThreadPool::TaskGroup group(pool());
+        group.run([=, this]() { mergeInPlace(first, cut1, newMiddle); });
+        mergeInPlace(newMiddle, cut2, last);
+        group.wait();
+    }
+
+    void reverseParallel(int* first, int* last) {
+        long long half = (last - first) / 2;
+        if (half < parallelMergeGrain) {
+            std::reverse(first, last);
+            return;
+        }
+        pool().parallelFor(0, half, [=](int, long long lo, long long hi) {
+            for (long long i = lo; i < hi; ++i) {
+                std::swap(first[i], last[-1 - i]);
+            }
+        });
+    }
+
+    void recordBranchMisses() {
+        if (branchMissesCounted) {
+            metrics["branch_misses"] = branchMisses.load();
+        } else {
+            metrics["branch_misses"] = nullptr;
+        }
+    }
+
+    // State of a splitter-based redistribution: keys end up grouped so bucket b holds values in (s_{b-1}, s_b]
+    struct SplitterPartition {
+        std::vector<int> samples;
+        std::vector<int> tree;                  // splitters in implicit search tree (BFS) order, padded to a power of two
+        int treeLeaves = 1;
+        std::vector<long long> counts;          // counts[t * T + b]: keys of thread t's block that fall in bucket b
+        std::vector<long long> offsets;         // where thread t writes its first key of bucket b
+        std::vector<long long> bucketBounds;    // bucket b occupies [bucketBounds[b], bucketBounds[b + 1]) of buffer
+        std::unique_ptr<uint32_t[]> bucketOf;   // classification of every key, reused by the scatter pass
+        std::unique_ptr<int[]> buffer;
+    };
+    SplitterPartition partition;
+    static constexpr int oversampling = 32;
+
+    // Branchless descent of the implicit splitter tree; eight keys walk the tree together so their loads overlap
+    // and the compiler can vectorise the inner loop. The result is the number of splitters below each key.
+    void classify(const int* keys, long long count, uint32_t* buckets, long long* bucketCounts) const {
+        const int* tree = partition.tree.data();
+        const int leaves = partition.treeLeaves;
+        constexpr int unroll = 8;
+        long long i = 0;
+        for (; i + unroll <= count; i += unroll) {
+            uint32_t node[unroll];
+            for (int u = 0; u < unroll; ++u) {
+                node[u] = 1;
+            }
+            for (int step = 1; step < leaves; step *= 2) {
+                for (int u = 0; u < unroll; ++u) {
+                    node[u] = 2 * node[u] + (keys[i + u] > tree[node[u]]);
+                }
+            }
+            for (int u = 0; u < unroll; ++u) {
+                buckets[i + u] = node[u] - leaves;
+                ++bucketCounts[node[u] - leaves];
+            }
+        }
+        for (; i < count; ++i) {
+            uint32_t node = 1;
+            for (int step = 1; step < leaves; step *= 2) {
+                node = 2 * node + (keys[i] > tree[node]);
+            }
+            buckets[i] = node - leaves;
+            ++bucketCounts[node - leaves];
+        }
+    }
+
+    // Cooperative phases run by every worker thread: sample, choose T-1 splitters, classify the thread's index
+    // block, prefix-sum the bucket counts and scatter into partition.buffer. On return bucket b is ready for thread b.
+    void partitionBySplitters(const int* data, long long data_size, std::barrier<>& sync_point, int thread_id, int thread_count) {
+        auto block = SortingAlgorithm::calculate_area_of_responsibility(thread_id, thread_count, data_size);
+        if (thread_id == 0) {
+            partition.samples.assign(static_cast<size_t>(oversampling) * thread_count, 0);
+            partition.counts.assign(static_cast<size_t>(thread_count) * thread_count, 0);
+            partition.offsets.assign(static_cast<size_t>(thread_count) * thread_count, 0);
+            partition.bucketBounds.assign(thread_count + 1, 0);
+            partition.bucketOf.reset(new uint32_t[data_size]);
+            partition.buffer.reset(new int[data_size]);
+        }
+        sync_point.arrive_and_wait();
+
+        std::mt19937 gen(std::random_device{}() + thread_id);
+        for (int k = 0; k < oversampling; ++k) {
+            // An empty block samples from the whole array so every thread contributes the same number of samples
+            long long first = block[0] < block[1] ? block[0] : 0;
+            long long last = block[0] < block[1] ? block[1] : data_size;
+            std::uniform_int_distribution<long long> pick(first, last - 1);
+            partition.samples[static_cast<size_t>(thread_id) * oversampling + k] = data[pick(gen)];
+        }
+        sync_point.arrive_and_wait();
+
+        if (thread_id == 0) {
+            std::sort(partition.samples.begin(), partition.samples.end());
+            int leaves = 1;
+            while (leaves < thread_count) {
+                leaves *= 2;
+            }
+            // Splitter i is the (i + 1)-th sample quantile; padding splitters are INT_MAX so their buckets stay empty
+            std::vector<int> splitters(leaves, INT_MAX);
+            for (int i = 0; i + 1 < thread_count; ++i) {
+                splitters[i] = partition.samples[static_cast<size_t>(i + 1) * oversampling - 1];
+            }
+            partition.treeLeaves = leaves;
+            partition.tree.assign(leaves, INT_MAX);
+            // In-order walk of the implicit tree assigns the sorted splitters to BFS positions
+            int next = 0;
+            std::function<void(int)> fill = [&](int node) {
+                if (node >= leaves) {
+                    return;
+                }
+                fill(2 * node);
+                partition.tree[node] = splitters[next++];
+                fill(2 * node + 1);
+            };
+            fill(1);
+        }
+        sync_point.arrive_and_wait();
+
+        long long* myCounts = partition.counts.data() + static_cast<size_t>(thread_id) * thread_count;
+        classify(data + block[0], block[1] - block[0], partition.bucketOf.get() + block[0], myCounts);
+        sync_point.arrive_and_wait();
+
+        if (thread_id == 0) {
+            long long running = 0;
+            for (int b = 0; b < thread_count; ++b) {
+                partition.bucketBounds[b] = running;
+                for (int t = 0; t < thread_count; ++t) {
+                    partition.offsets[static_cast<size_t>(t) * thread_count + b] = running;
+                    running += partition.counts[static_cast<size_t>(t) * thread_count + b];
+                }
+            }
+            partition.bucketBounds[thread_count] = running;
+        }
+        sync_point.arrive_and_wait();
+
+        std::vector<long long> next(partition.offsets.begin() + static_cast<long long>(thread_id) * thread_count,
+                                    partition.offsets.begin() + static_cast<long long>(thread_id + 1) * thread_count);
+        const uint32_t* buckets = partition.bucketOf.get();
+        int* buffer = partition.buffer.get();
+        for (long long i = block[0]; i < block[1]; ++i) {
+            buffer[next[buckets[i]]++] = data[i];
+        }
+        sync_point.arrive_and_wait();
+    }
+
+    void recordBucketImbalance(int thread_count, long long data_size) {
+        long long largest = 0;
+        for (int b = 0; b < thread_count; ++b) {
+            largest = std::max(largest, partition.bucketBounds[b + 1] - partition.bucketBounds[b]);
+        }
+        metrics["bucket_imbalance"] = data_size > 0 ? static_cast<double>(largest) * thread_count / static_cast<double>(data_size) : 1.0;
+    }
+
+    uint64_t fingerprintSeed = 0;
+    uint64_t inputFingerprint = 0;
+
+    // splitmix64 finalizer of the seeded key; summing it over all elements gives an order-independent multiset hash
+    static uint64_t mixKey(int value, uint64_t seed) {
+        uint64_t z = static_cast<uint64_t>(static_cast<uint32_t>(value)) + seed + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t multisetFingerprint(const int* values, long long count) {
+        std::vector<uint64_t> partial(pool().size() + 1, 0);
+        pool().parallelFor(0, count, [&](int chunk, long long first, long long last) {
+            uint64_t sum = 0;
+            for (long long i = first; i < last; ++i) {
+                sum += mixKey(values[i], fingerprintSeed);
+            }
+            partial[chunk] = sum;
+        });
+        return std::accumulate(partial.begin(), partial.end(), uint64_t{0});
+    }
+
+    void prepare_test_result(const std::vector<int*>& input_data, long long dataSize) override {
+        fingerprintSeed = std::random_device{}() * 0x100000001b3ULL ^ std::random_device{}();
+        inputFingerprint = multisetFingerprint(input_data[0], dataSize);
+    }
+
+    // The output must be ordered and hold the same multiset of keys as the input; both checks run on the pool.
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        const int* sorted_data = result[0]; // Assuming the sorted result is stored in the first element
+        std::atomic<long long> firstUnordered = LLONG_MAX;
+        pool().parallelFor(1, dataSize, [&](int, long long first, long long last) {
+            for (long long i = first; i < last; ++i) {
+                if (sorted_data[i - 1] > sorted_data[i]) {
+                    long long seen = firstUnordered.load();
+                    while (i < seen && !firstUnordered.compare_exchange_weak(seen, i)) {}
+                    break;
+                }
+            }
+        });
+        if (firstUnordered != LLONG_MAX) {
+            long long i = firstUnordered;
+            std::cout << "Sorting failed at index " << i << ": " << sorted_data[i - 1] << " > " << sorted_data[i] << std::endl;
+            return false;
+        }
+        if (multisetFingerprint(sorted_data, dataSize) != inputFingerprint) {
+            std::cout << "Sorting failed: output is not a permutation of the input." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>&  stopFlag) override {
+        int* data = inputData[0]; // Access the data
+        long long start = area_of_responsibility[0];
+        long long end = area_of_responsibility[1];
+        sortSegmentCounted(data, start, end);
+        return {}; // Sorting is in-place; no need to return data here
+    }
+
+    // With splitter partitioning every thread helps move the keys into value-ordered buckets first and then sorts
+    // bucket thread_id, so thread i owns the value range (s_{i-1}, s_i] and the buckets need no merge.
+    std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData,
+        std::atomic<bool>& stopFlag, std::barrier<>& sync_point, int thread_id) override {
+        if (!options.splitterPartition) {
+            return execute(area_of_responsibility, inputData, stopFlag);
+        }
+        partitionBySplitters(inputData[0], dataSize, sync_point, thread_id, threadCount);
+        sortSegmentCounted(partition.buffer.get(), partition.bucketBounds[thread_id], partition.bucketBounds[thread_id + 1]);
+        return {};
+    }
+
+    void sortSegmentCounted(int* data, long long start, long long end) {
+        BranchMissCounter counter;
+        sortSegment(data, start, end);
+        long long misses = counter.read();
+        if (misses >= 0) {
+            branchMisses += misses;
+        } else {
+            branchMissesCounted = false;
+        }
+    }
+
+    std::vector<int*> generateData(long long dataSize) override {
+        if (!options.datasetPath.empty()) {
+            return {loadDataset(dataSize, true)}; // sorts work in place
+        }
+        auto* data = new int[dataSize]; // Dynamically allocate array
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        generateKeys(data, dataSize, gen);
+        return {data}; // Return the generated data as a vector containing a pointer
+    }
+
+    // Fills data with keys from the configured range and distribution
+    void generateKeys(int* data, long long dataSize, std::mt19937& gen) const {
+        if (options.keyDistribution == KeyDistribution::Skewed) {
+            // u^4 piles keys up at the low end of the range: the lowest 1/16 of the range gets half of them
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            double span = static_cast<double>(options.sortKeyMax) - static_cast<double>(options.sortKeyMin) + 1.0;
+            for (long long i = 0; i < dataSize; ++i) {
+                double u = unit(gen);
+                double offset = std::min(std::floor(span * u * u * u * u), span - 1.0);
+                data[i] = static_cast<int>(static_cast<long long>(options.sortKeyMin) + static_cast<long long>(offset));
+            }
+        } else {
+            std::uniform_int_distribution<> dis(options.sortKeyMin, options.sortKeyMax);
+            for (long long i = 0; i < dataSize; ++i) {
+                data[i] = dis(gen);
+            }
+        }
+
+        if (options.keyDistribution == KeyDistribution::NearlySorted && dataSize > 0) {
+            // Sorted, then 1% of the keys swapped with a random partner
+            std::sort(data, data + dataSize);
+            std::uniform_int_distribution<long long> position(0, dataSize - 1);
+            for (long long swaps = dataSize / 200; swaps > 0; --swaps) {
+                std::swap(data[position(gen)], data[position(gen)]);
+            }
+        } else if (options.keyDistribution == KeyDistribution::Runs) {
+            // Consecutive sorted runs of 1 to 2 * runMean keys, a quarter of them descending
+            constexpr long long runMean = 1 << 10;
+            std::uniform_int_distribution<long long> runLength(1, 2 * runMean);
+            std::bernoulli_distribution descending(0.25);
+            for (long long begin = 0; begin < dataSize;) {
+                long long end = std::min(begin + runLength(gen), dataSize);
+                if (descending(gen)) {
+                    std::sort(data + begin, data + end, std::greater<>());
+                } else {
+                    std::sort(data + begin, data + end);
+                }
+                begin = end;
+            }
+        }
+    }
+
+    std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) override {
+        long long segmentSize = dataSize / maxThreads;
+        return {currentThread * segmentSize, (currentThread == maxThreads - 1) ? dataSize : (currentThread + 1) * segmentSize};
+    }
+
+    [[nodiscard]] std::pair<long long, long long> inputShape(long long dataSize) const override {
+        return {1, dataSize};
+    }
+
+    virtual void sortSegment(int* data, long long start, long long end) = 0;
+
+    [[nodiscard]] SimdLevel networkLevel() const {
+        return std::min(options.simdLevel, detectSimdLevel());
+    }
+};
+
+
+// ===================== Algorithms =====================
+class BubbleSort : public SortingAlgorithm {
+public:
+    BubbleSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "BubbleSort";
+    }
+
+protected:
+    void sortSegment(int* data, long long start, long long end) override {
+        for (long long i = start; i < end - 1; ++i) {
+            for (long long j = start; j < end - 1 - (i - start); ++j) {
+                if (data[j] > data[j + 1]) {
+                    std::swap(data[j], data[j + 1]);
+                }
+            }
+        }
+    }
+};
+
+// Odd-even transposition sort: every thread compare-exchanges its share of the even or odd neighbour pairs of the
+// whole array, then all threads meet at a barrier before the next phase. The work per phase is tiny, so this
+// mostly measures the cost of synchronisation.
+class OddEvenTranspositionSort : public BubbleSort {
+public:
+    OddEvenTranspositionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : BubbleSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "OddEvenTranspositionSort";
+    }
+
+protected:
+    // Runs once per phase on the last thread to arrive; decides whether another phase is needed
+    struct PhaseCompletion {
+        OddEvenTranspositionSort* self;
+        void operator()() noexcept {
+            self->quietPhases = self->swapped.exchange(false, std::memory_order_relaxed) ? 0 : self->quietPhases + 1;
+            ++self->phases;
+            // Sorted once an even and an odd phase in a row changed nothing; n phases always suffice
+            self->finished = self->quietPhases >= 2 || self->phases >= self->dataSize;
+        }
+    };
+
+    std::unique_ptr<std::barrier<PhaseCompletion>> phaseBarrier;
+    std::atomic<bool> swapped{false};
+    long long phases = 0;
+    long long quietPhases = 0;
+    bool finished = false;
+    std::atomic<long long> barrierWaitNs{0};
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = BubbleSort::generateData(dataSize);
+        phaseBarrier = std::make_unique<std::barrier<PhaseCompletion>>(threadCount, PhaseCompletion{this});
+        swapped = false;
+        phases = 0;
+        quietPhases = 0;
+        finished = dataSize < 2;
+        barrierWaitNs = 0;
+        return data;
+    }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>&, int thread_id) override {
+        int* data = inputData[0];
+        long long pairs = dataSize - 1; // pair i compares data[i] and data[i + 1]
+        long long lo = pairs * thread_id / threadCount;
+        long long hi = pairs * (thread_id + 1) / threadCount;
+        long long waited = 0;
+
+        for (long long phase = 0; !finished; ++phase) {
+            bool changed = false;
+            for (long long i = lo + ((lo ^ phase) & 1); i < hi; i += 2) {
+                int a = data[i];
+                int b = data[i + 1];
+                data[i] = std::min(a, b);
+                data[i + 1] = std::max(a, b);
+                changed |= a > b;
+            }
+            if (changed) {
+                swapped.store(true, std::memory_order_relaxed);
+            }
+            auto arrived = std::chrono::steady_clock::now();
+            phaseBarrier->arrive_and_wait();
+            waited += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - arrived).count();
+        }
+        barrierWaitNs.fetch_add(waited, std::memory_order_relaxed);
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>& inputData, int thread_count, long long) override {
+        metrics["phases"] = phases;
+        metrics["barrier_wait_ns_per_phase"] = phases > 0 ? static_cast<double>(barrierWaitNs.load()) / (static_cast<double>(phases) * thread_count) : 0.0;
+        return {inputData[0]}; // sorted in place, nothing to merge
+    }
+};
+
+class SampleSort : public SortingAlgorithm {
+public:
+    SampleSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SampleSort";
+    }
+
+protected:
+    // Every thread helps redistribute the keys into one bucket per thread, then sorts its own bucket.
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>& sync_point, int thread_id) override {
+        partitionBySplitters(inputData[0], dataSize, sync_point, thread_id, threadCount);
+        sortSegment(partition.buffer.get(), partition.bucketBounds[thread_id], partition.bucketBounds[thread_id + 1]);
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int thread_count, long long data_size) override {
+        recordBucketImbalance(thread_count, data_size);
+        return {partition.buffer.get()}; // buckets are already in order, nothing to merge
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        std::sort(data + start, data + end);
+    }
+};
+
+class PdqSort : public SortingAlgorithm {
+public:
+    PdqSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "PdqSort";
+    }
+
+protected:
+    void sortSegment(int* data, long long start, long long end) override {
+        PdqSortKernel::sort(data + start, data + end);
+    }
+};
+
+class QuickSort : public SortingAlgorithm {
+public:
+    QuickSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "QuickSort";
+    }
+
+protected:
+    // Median-of-three quicksort that hands segments of up to 256 keys to the bitonic network,
+    // with a heapsort fallback once the recursion gets too deep
+    void sortSegment(int* data, long long start, long long end) override {
+        sortRange(data, start, end, 2 * std::bit_width(static_cast<unsigned long long>(end - start)));
+    }
+
+    // Recursive or explicit-stack version, depending on the iterative flag
+    void sortRange(int* data, long long start, long long end, int depthLimit) {
+        if (iterativeMode()) {
+            quickSortIterative(data, start, end, depthLimit, networkLevel());
+        } else {
+            quickSort(data, start, end, depthLimit, networkLevel());
+        }
+    }
+
+    // Hoare partition around the median of the first, middle and last key; returns the start of the right side
+    static long long partitionAroundMedian(int* data, long long start, long long end) {
+        long long middle = start + (end - start) / 2;
+        if (data[middle] < data[start]) std::swap(data[middle], data[start]);
+        if (data[end - 1] < data[start]) std::swap(data[end - 1], data[start]);
+        if (data[end - 1] < data[middle]) std::swap(data[end - 1], data[middle]);
+        int pivot = data[middle];
+
+        long long i = start - 1;
+        long long j = end;
+        while (true) {
+            do { ++i; } while (data[i] < pivot);
+            do { --j; } while (data[j] > pivot);
+            if (i >= j) break;
+            std::swap(data[i], data[j]);
+        }
+        return j + 1;
+    }
+
+    static void heapSortRange(int* data, long long start, long long end) {
+        std::make_heap(data + start, data + end);
+        std::sort_heap(data + start, data + end);
+    }
+
+    void quickSort(int* data, long long start, long long end, int depthLimit, SimdLevel level) {
+        while (end - start > BitonicNetwork::maxSize) {
+            if (depthLimit-- == 0) {
+                heapSortRange(data, start, end);
+                return;
+            }
+            long long split = partitionAroundMedian(data, start, end);
+            // Recurse into the smaller side and loop on the larger one to bound the stack depth
+            if (split - start < end - split) {
+                quickSort(data, start, split, depthLimit, level);
+                start = split;
+            } else {
+                quickSort(data, split, end, depthLimit, level);
+                end = split;
+            }
+        }
+        sortSmallBlock(data + start, end - start, level);
+    }
+
+    // Same algorithm without recursion: the larger side of each split is pushed on a fixed-size stack and the
+    // smaller side is processed next, so at most log2(n) ranges are ever pending.
+    void quickSortIterative(int* data, long long start, long long end, int depthLimit, SimdLevel level) {
+        struct Range {
+            long long start, end;
+            int depthLimit;
+        };
+        std::array<Range, 128> stack;
+        int top = 0;
+        stack[top++] = {start, end, depthLimit};
+        while (top > 0) {
+            Range range = stack[--top];
+            while (range.end - range.start > BitonicNetwork::maxSize) {
+                if (range.depthLimit-- == 0) {
+                    heapSortRange(data, range.start, range.end);
+                    range.end = range.start;
+                    break;
+                }
+                long long split = partitionAroundMedian(data, range.start, range.end);
+                if (split - range.start < range.end - split) {
+                    stack[top++] = {split, range.end, range.depthLimit};
+                    range.end = split;
+                } else {
+                    stack[top++] = {range.start, split, range.depthLimit};
+                    range.start = split;
+                }
+            }
+            sortSmallBlock(data + range.start, range.end - range.start, level);
+        }
+    }
+};
+
+
+// Parallel LSD radix sort on 8-bit digits of (key - min). Each pass builds per-thread histograms, turns them into
+// scatter offsets with a prefix sum, and scatters through per-thread write-combining buffers of one cache line per
+// digit. CountingSort shares the implementation and takes a counting path, which writes the output straight back
+// into the input, whenever the key range is small enough.
+class RadixSort : public SortingAlgorithm {
+public:
+    RadixSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "RadixSort";
+    }
+
+protected:
+    static constexpr int radixBits = 8;
+    static constexpr int radix = 1 << radixBits;
+    static constexpr int combineWidth = 64 / sizeof(int); // keys per write-combining line
+
+    // Largest key range (max - min + 1) handled by counting sort instead of radix passes; RadixSort always runs the passes
+    virtual long long countingRangeLimit() const {
+        return 0;
+    }
+
+    std::vector<int> threadMin, threadMax;
+    std::vector<long long> histograms;             // histograms[t * radix + digit]
+    std::vector<std::vector<long long>> valueCounts; // counting path: one histogram over the key range per thread
+    std::vector<long long> sliceTotals;
+    std::unique_ptr<int[]> buffer;
+    int* sorted = nullptr;
+    bool skipPass = false;
+    int passesRun = 0;
+    std::chrono::high_resolution_clock::time_point passesStart;
+
+    std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>& sync_point, int thread_id) override {
+        const int thread_count = threadCount;
+        int* data = inputData[0];
+        const long long first = area_of_responsibility[0];
+        const long long last = area_of_responsibility[1];
+        if (thread_id == 0) {
+            threadMin.assign(thread_count, INT_MAX);
+            threadMax.assign(thread_count, INT_MIN);
+            histograms.assign(static_cast<size_t>(thread_count) * radix, 0);
+            valueCounts.assign(thread_count, {});
+            sliceTotals.assign(thread_count, 0);
+            sorted = data;
+            passesRun = 0;
+        }
+        sync_point.arrive_and_wait();
+
+        int localMin = INT_MAX, localMax = INT_MIN;
+        for (long long i = first; i < last; ++i) {
+            localMin = std::min(localMin, data[i]);
+            localMax = std::max(localMax, data[i]);
+        }
+        threadMin[thread_id] = localMin;
+        threadMax[thread_id] = localMax;
+        sync_point.arrive_and_wait();
+
+        const int low = *std::min_element(threadMin.begin(), threadMin.end());
+        const int high = *std::max_element(threadMax.begin(), threadMax.end());
+        if (low > high) {
+            return {}; // nothing to sort
+        }
+        const auto range = static_cast<uint32_t>(static_cast<long long>(high) - low);
+        if (thread_id == 0) {
+            passesStart = std::chrono::high_resolution_clock::now();
+        }
+        if (static_cast<long long>(range) < countingRangeLimit()) {
+            countingSort(data, first, last, sync_point, thread_id, low, static_cast<long long>(range) + 1);
+            return {};
+        }
+
+        if (thread_id == 0) {
+            buffer.reset(new int[dataSize]);
+        }
+        sync_point.arrive_and_wait();
+
+        int* source = data;
+        int* destination = buffer.get();
+        int significantBits = std::bit_width(range);
+        for (int shift = 0; shift < significantBits; shift += radixBits) {
+            long long* histogram = histograms.data() + static_cast<size_t>(thread_id) * radix;
+            std::fill(histogram, histogram + radix, 0);
+            for (long long i = first; i < last; ++i) {
+                ++histogram[digitOf(source[i], low, shift)];
+            }
+            sync_point.arrive_and_wait();
+
+            if (thread_id == 0) {
+                // Column-major exclusive prefix sum: all of digit 0 (thread by thread), then digit 1, ...
+                long long running = 0;
+                int nonEmptyDigits = 0;
+                for (int digit = 0; digit < radix; ++digit) {
+                    long long before = running;
+                    for (int t = 0; t < thread_count; ++t) {
+                        long long count = histograms[static_cast<size_t>(t) * radix + digit];
+                        histograms[static_cast<size_t>(t) * radix + digit] = running;
+                        running += count;
+                    }
+                    nonEmptyDigits += running > before;
+                }
+                skipPass = nonEmptyDigits <= 1; // every key has the same digit, the order would not change
+                passesRun += !skipPass;
+            }
+            sync_point.arrive_and_wait();
+
+            if (!skipPass) {
+                scatter(source, destination, first, last, histogram, low, shift);
+                std::swap(source, destination);
+                sync_point.arrive_and_wait();
+            }
+        }
+
+        if (thread_id == 0) {
+            sorted = source;
+            std::chrono::duration<double> passesDuration = std::chrono::high_resolution_clock::now() - passesStart;
+            metrics["counting_sort"] = false;
+            metrics["passes"] = passesRun;
+            metrics["passes_per_second"] = passesDuration.count() > 0 ? passesRun / passesDuration.count() : 0.0;
+        }
+        return {};
+    }
+
+    static uint32_t digitOf(int key, int low, int shift) {
+        return ((static_cast<uint32_t>(key) - static_cast<uint32_t>(low)) >> shift) & (radix - 1);
+    }
+
+    // Keys are staged per digit in a cache-line-sized slot and written out a full line at a time,
+    // so the scatter streams whole lines instead of touching up to 256 partial lines per key.
+    void scatter(const int* source, int* destination, long long first, long long last, const long long* offsets, int low, int shift) {
+        alignas(64) static thread_local int lines[radix][combineWidth];
+        int fill[radix] = {};
+        long long next[radix];
+        std::copy(offsets, offsets + radix, next);
+        for (long long i = first; i < last; ++i) {
+            int key = source[i];
+            uint32_t digit = digitOf(key, low, shift);
+            lines[digit][fill[digit]++] = key;
+            if (fill[digit] == combineWidth) {
+                std::copy(lines[digit], lines[digit] + combineWidth, destination + next[digit]);
+                next[digit] += combineWidth;
+                fill[digit] = 0;
+            }
+        }
+        for (int digit = 0; digit < radix; ++digit) {
+            std::copy(lines[digit], lines[digit] + fill[digit], destination + next[digit]);
+        }
+    }
+
+    // Each thread counts its block, then owns a contiguous slice of key values: it totals their counts across
+    // threads and writes the runs of equal keys back into the input at the slice's output offset.
+    void countingSort(int* data, long long first, long long last, std::barrier<>& sync_point, int thread_id, int low, long long range) {
+        const int thread_count = threadCount;
+        auto& counts = valueCounts[thread_id];
+        counts.assign(range, 0);
+        for (long long i = first; i < last; ++i) {
+            ++counts[static_cast<uint32_t>(data[i]) - static_cast<uint32_t>(low)];
+        }
+        sync_point.arrive_and_wait();
+
+        long long sliceFirst = range * thread_id / thread_count;
+        long long sliceLast = range * (thread_id + 1) / thread_count;
+        auto& totals = valueCounts[0]; // thread 0's row is complete, so it can hold the totals
+        long long sliceTotal = 0;
+        for (long long value = sliceFirst; value < sliceLast; ++value) {
+            long long total = 0;
+            for (int t = 0; t < thread_count; ++t) {
+                total += valueCounts[t][value];
+            }
+            totals[value] = total;
+            sliceTotal += total;
+        }
+        sliceTotals[thread_id] = sliceTotal;
+        sync_point.arrive_and_wait();
+
+        long long position = std::accumulate(sliceTotals.begin(), sliceTotals.begin() + thread_id, 0LL);
+        for (long long value = sliceFirst; value < sliceLast; ++value) {
+            std::fill_n(data + position, totals[value], static_cast<int>(low + value));
+            position += totals[value];
+        }
+        sync_point.arrive_and_wait();
+        if (thread_id == 0) {
+            std::chrono::duration<double> passesDuration = std::chrono::high_resolution_clock::now() - passesStart;
+            metrics["counting_sort"] = true;
+            metrics["passes"] = 1;
+            metrics["passes_per_second"] = passesDuration.count() > 0 ? 1 / passesDuration.count() : 0.0;
+        }
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int, long long) override {
+        return {sorted}; // the last radix pass wrote either the input array or the buffer
+    }
+
+    // Serial LSD radix sort of one segment, for callers that sort independent slices
+    void sortSegment(int* data, long long start, long long end) override {
+        if (end - start <= 1) {
+            return;
+        }
+        int low = *std::min_element(data + start, data + end);
+        int high = *std::max_element(data + start, data + end);
+        std::vector<int> scratch(end - start);
+        int* source = data + start;
+        int* destination = scratch.data();
+        const int bits = static_cast<int>(std::bit_width(static_cast<uint32_t>(static_cast<long long>(high) - low)));
+        for (int shift = 0; shift < bits; shift += radixBits) {
+            long long offsets[radix] = {};
+            for (long long i = 0; i < end - start; ++i) {
+                ++offsets[digitOf(source[i], low, shift)];
+            }
+            long long running = 0;
+            for (auto& offset : offsets) {
+                running += std::exchange(offset, running);
+            }
+            for (long long i = 0; i < end - start; ++i) {
+                destination[offsets[digitOf(source[i], low, shift)]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+        if (source != data + start) {
+            std::copy(source, source + (end - start), data + start);
+        }
+    }
+};
+
+// Counting sort whenever the key range fits a per-thread histogram, otherwise the radix passes
+class CountingSort : public RadixSort {
+public:
+    CountingSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : RadixSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "CountingSort";
+    }
+
+protected:
+    // Every thread holds a long long count per key value: at most 2^24 values, and 2^23 counts (64 MiB) over all threads
+    long long countingRangeLimit() const override {
+        return std::clamp((1LL << 23) / threadCount, 1LL << 16, 1LL << 24);
+    }
+};
+
+class MergeSort : public SortingAlgorithm {
+public:
+    MergeSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "MergeSort";
+    }
+
+protected:
+    static constexpr long long initialRunLength = 32;
+    std::unique_ptr<int[]> scratch; // ping-pong partner of the input for the iterative version, one slice per thread
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = SortingAlgorithm::generateData(dataSize);
+        if (iterativeMode() && !options.inPlaceMerge) {
+            scratch.reset(new int[dataSize]);
+        }
+        return data;
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        if (iterativeMode()) {
+            sortSegmentBottomUp(data, start, end);
+        } else {
+            sortSegmentRecursive(data, start, end);
+        }
+    }
+
+    void sortSegmentRecursive(int* data, long long start, long long end) {
+        if (end - start <= BitonicNetwork::maxSize) {
+            sortSmallBlock(data + start, end - start, networkLevel());
+            return;
+        }
+        long long mid = start + (end - start) / 2;
+        sortSegmentRecursive(data, start, mid);
+        sortSegmentRecursive(data, mid, end);
+        if (options.inPlaceMerge) {
+            InPlaceMerge::merge(data + start, data + mid, data + end);
+            return;
+        }
+
+        // Temporary array for merging
+        std::vector<int> temp(end - start);
+        std::merge(data + start, data + mid, data + mid, data + end, temp.begin());
+        std::copy(temp.begin(), temp.end(), data + start);
+    }
+
+    // Insertion-sorted runs of 32 keys, then merge passes of doubling width that alternate between the
+    // segment and its slice of the preallocated scratch buffer; no allocation happens while sorting.
+    void sortSegmentBottomUp(int* data, long long start, long long end) {
+        const long long length = end - start;
+        for (long long run = start; run < end; run += initialRunLength) {
+            PdqSortKernel::insertionSort(data + run, data + std::min(run + initialRunLength, end));
+        }
+        if (options.inPlaceMerge) {
+            for (long long width = initialRunLength; width < length; width *= 2) {
+                for (long long left = start; left + width < end; left += 2 * width) {
+                    InPlaceMerge::merge(data + left, data + left + width, data + std::min(left + 2 * width, end));
+                }
+            }
+            return;
+        }
+        const SimdLevel level = networkLevel();
+        int* source = data + start;
+        int* destination = scratch.get() + start;
+        for (long long width = initialRunLength; width < length; width *= 2) {
+            for (long long left = 0; left < length; left += 2 * width) {
+                long long middle = std::min(left + width, length);
+                long long right = std::min(left + 2 * width, length);
+                mergeSortedRuns(source + left, middle - left, source + middle, right - middle, destination + left, level);
+            }
+            std::swap(source, destination);
+        }
+        if (source != data + start) {
+            std::copy(source, source + length, data + start);
+        }
+    }
+};
+
+// Natural merge sort with the powersort merge policy: each thread finds the ascending (or strictly descending,
+// reversed) runs in its slice, extends short ones to minRun keys, and merges neighbouring runs by node power.
+// Merges gallop once one side keeps winning. The sorted slices are then merged across thread boundaries the same way.
+class PowerSort : public SortingAlgorithm {
+public:
+    PowerSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "PowerSort";
+    }
+
+protected:
+    static constexpr long long minRun = 32;
+    static constexpr int minGallop = 7;
+    std::atomic<long long> runsDetected = 0;
+    std::atomic<long long> runKeys = 0;      // keys covered by natural runs, before short runs are extended
+    std::atomic<long long> longestRun = 0;
+    std::atomic<long long> boundaryKeys = 0; // keys that still had to move when merging the sorted slices
+
+    struct Run {
+        long long begin;
+        long long end;
+        int power;
+    };
+
+    std::vector<int*> generateData(long long dataSize) override {
+        runsDetected = 0;
+        runKeys = 0;
+        longestRun = 0;
+        boundaryKeys = 0;
+        return SortingAlgorithm::generateData(dataSize);
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        std::vector<int> buffer;
+        std::vector<Run> stack;
+        long long runs = 0;
+        long long covered = 0;
+        long long longest = 0;
+        auto nextRun = [&](long long begin) {
+            long long natural = naturalRunEnd(data, begin, end);
+            ++runs;
+            covered += natural - begin;
+            longest = std::max(longest, natural - begin);
+            long long runEnd = std::max(natural, std::min(begin + minRun, end));
+            PdqSortKernel::insertionSort(data + begin, data + runEnd); // the natural prefix is already in order
+            return Run{begin, runEnd, 0};
+        };
+
+        Run current = nextRun(start);
+        while (current.end < end) {
+            Run next = nextRun(current.end);
+            int power = nodePower(start, end, current, next);
+            while (!stack.empty() && stack.back().power > power) {
+                mergeRuns(data + stack.back().begin, data + current.begin, data + current.end, buffer);
+                current.begin = stack.back().begin;
+                stack.pop_back();
+            }
+            current.power = power;
+            stack.push_back(current);
+            current = next;
+        }
+        while (!stack.empty()) {
+            mergeRuns(data + stack.back().begin, data + current.begin, data + current.end, buffer);
+            current.begin = stack.back().begin;
+            stack.pop_back();
+        }
+
+        runsDetected += runs;
+        runKeys += covered;
+        long long seen = longestRun.load();
+        while (longest > seen && !longestRun.compare_exchange_weak(seen, longest)) {}
+    }
+
+    // Pairwise merge tree over the sorted slices; galloping trims the parts already in place, so presorted
+    // input only moves the keys that overlap across a boundary
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        if (options.splitterPartition) {
+            return SortingAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+        }
+        recordBranchMisses();
+        int* data = inputData[0];
+        std::vector<long long> bounds;
+        for (int i = 0; i < thread_count; ++i) {
+            bounds.push_back(calculate_area_of_responsibility(i, thread_count, data_size)[0]);
+        }
+        bounds.push_back(data_size);
+        while (bounds.size() > 2) {
+            std::vector<long long> next;
+            ThreadPool::TaskGroup group(pool());
+            for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                next.push_back(bounds[i]);
+                if (i + 2 < bounds.size()) {
+                    group.run([=, this]() {
+                        std::vector<int> buffer;
+                        boundaryKeys += mergeRuns(data + bounds[i], data + bounds[i + 1], data + bounds[i + 2], buffer);
+                    });
+                }
+            }
+            next.push_back(data_size);
+            group.wait();
+            bounds = std::move(next);
+        }
+
+        long long runs = runsDetected.load();
+        metrics["runs"] = runs;
+        metrics["mean_run_length"] = runs > 0 ? static_cast<double>(runKeys.load()) / static_cast<double>(runs) : 0.0;
+        metrics["max_run_length"] = longestRun.load();
+        metrics["boundary_merge_keys"] = boundaryKeys.load();
+        return {data};
+    }
+
+    // End of the natural run starting at begin; a strictly descending run is reversed in place
+    static long long naturalRunEnd(int* data, long long begin, long long end) {
+        long long i = begin + 1;
+        if (i >= end) {
+            return end;
+        }
+        if (data[i] < data[i - 1]) {
+            while (i + 1 < end && data[i + 1] < data[i]) {
+                ++i;
+            }
+            std::reverse(data + begin, data + i + 1);
+        } else {
+            while (i + 1 < end && data[i + 1] >= data[i]) {
+                ++i;
+            }
+        }
+        return i + 1;
+    }
+
+    // Depth of the boundary between runs a and b in the segment's virtual balanced merge tree: the first bit in which
+    // the runs' midpoints, as fractions of the segment, differ. Computed on doubled positions to stay in integers.
+    static int nodePower(long long start, long long end, const Run& a, const Run& b) {
+        unsigned long long scale = 2 * static_cast<unsigned long long>(end - start);
+        unsigned long long left = static_cast<unsigned long long>(a.begin - start) + static_cast<unsigned long long>(a.end - start);
+        unsigned long long right = static_cast<unsigned long long>(b.begin - start) + static_cast<unsigned long long>(b.end - start);
+        int power = 0;
+        while (true) {
+            ++power;
+            left *= 2;
+            right *= 2;
+            if (right < scale) {
+                continue;
+            }
+            if (left >= scale) {
+                left -= scale;
+                right -= scale;
+                continue;
+            }
+            return power;
+        }
+    }
+
+    // First position in [first, last) where pred fails, pred holding on a prefix; probes 1, 2, 4, ... keys from the front
+    template <class Predicate>
+    static int* gallopForward(int* first, int* last, Predicate pred) {
+        long long length = last - first;
+        long long bound = 1;
+        while (bound <= length && pred(first[bound - 1])) {
+            bound *= 2;
+        }
+        return std::partition_point(first + bound / 2, first + std::min(bound - 1, length), pred);
+    }
+
+    // First position of the suffix of [first, last) on which pred holds; probes from the back
+    template <class Predicate>
+    static int* gallopBackward(int* first, int* last, Predicate pred) {
+        long long length = last - first;
+        long long bound = 1;
+        while (bound <= length && pred(last[-bound])) {
+            bound *= 2;
+        }
+        return std::partition_point(last - std::min(bound - 1, length), last - bound / 2, [&](int key) { return !pred(key); });
+    }
+
+    // Stable merge of adjacent runs through a buffer the size of the shorter run left after trimming the keys
+    // already in place; returns how many keys took part in the merge
+    static long long mergeRuns(int* first, int* middle, int* last, std::vector<int>& buffer) {
+        if (first == middle || middle == last) {
+            return 0;
+        }
+        first = gallopForward(first, middle, [pivot = *middle](int key) { return key <= pivot; });
+        last = gallopBackward(middle, last, [pivot = middle[-1]](int key) { return key >= pivot; });
+        if (first == middle || middle == last) {
+            return 0;
+        }
+        if (middle - first <= last - middle) {
+            mergeLow(first, middle, last, buffer);
+        } else {
+            mergeHigh(first, middle, last, buffer);
+        }
+        return last - first;
+    }
+
+    // Left run goes to the buffer and the merge fills the array from the front
+    static void mergeLow(int* first, int* middle, int* last, std::vector<int>& buffer) {
+        buffer.assign(first, middle);
+        int* a = buffer.data();
+        int* aEnd = a + buffer.size();
+        int* b = middle;
+        int* out = first;
+        int aWins = 0;
+        int bWins = 0;
+        while (a < aEnd && b < last) {
+            if (*b < *a) {
+                *out++ = *b++;
+                ++bWins;
+                aWins = 0;
+            } else {
+                *out++ = *a++;
+                ++aWins;
+                bWins = 0;
+            }
+            if (aWins < minGallop && bWins < minGallop) {
+                continue;
+            }
+            // Galloping: copy whole stretches found by exponential search until both stretches get short
+            while (a < aEnd && b < last) {
+                int* aStop = gallopForward(a, aEnd, [pivot = *b](int key) { return key <= pivot; });
+                long long aStretch = aStop - a;
+                out = std::copy(a, aStop, out);
+                a = aStop;
+                if (a == aEnd) {
+                    break;
+                }
+                int* bStop = gallopForward(b, last, [pivot = *a](int key) { return key < pivot; });
+                long long bStretch = bStop - b;
+                out = std::copy(b, bStop, out);
+                b = bStop;
+                if (aStretch < minGallop && bStretch < minGallop) {
+                    break;
+                }
+            }
+            aWins = 0;
+            bWins = 0;
+        }
+        std::copy(a, aEnd, out); // whatever is left of the right run is already in place
+    }
+
+    // Right run goes to the buffer and the merge fills the array from the back
+    static void mergeHigh(int* first, int* middle, int* last, std::vector<int>& buffer) {
+        buffer.assign(middle, last);
+        int* bBegin = buffer.data();
+        int* bEnd = bBegin + buffer.size();
+        int* a = middle;
+        int* out = last;
+        int aWins = 0;
+        int bWins = 0;
+        while (first < a && bBegin < bEnd) {
+            if (bEnd[-1] < a[-1]) {
+                *--out = *--a;
+                ++aWins;
+                bWins = 0;
+            } else {
+                *--out = *--bEnd;
+                ++bWins;
+                aWins = 0;
+            }
+            if (aWins < minGallop && bWins < minGallop) {
+                continue;
+            }
+            while (first < a && bBegin < bEnd) {
+                int* aStop = gallopBackward(first, a, [pivot = bEnd[-1]](int key) { return key > pivot; });
+                long long aStretch = a - aStop;
+                out = std::copy_backward(aStop, a, out);
+                a = aStop;
+                if (a == first) {
+                    break;
+                }
+                int* bStop = gallopBackward(bBegin, bEnd, [pivot = a[-1]](int key) { return key >= pivot; });
+                long long bStretch = bEnd - bStop;
+                out = std::copy_backward(bStop, bEnd, out);
+                bEnd = bStop;
+                if (aStretch < minGallop && bStretch < minGallop) {
+                    break;
+                }
+            }
+            aWins = 0;
+            bWins = 0;
+        }
+        std::copy_backward(bBegin, bEnd, out); // whatever is left of the left run is already in place
+    }
+};
+
+// Fork-join quicksort on the algorithm's pool: large ranges are partitioned in parallel, both sides become tasks,
+// and ranges under the grain size finish with the serial QuickSort kernel. The array ends up sorted in place.
+class ParallelQuickSort : public QuickSort {
+public:
+    ParallelQuickSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : QuickSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "ParallelQuickSort";
+    }
+
+protected:
+    static constexpr long long grainSize = 1 << 13;
+    static constexpr long long parallelPartitionSize = 1 << 17;
+    std::atomic<long long> tasks = 0;
+
+    // Thread 0 drives the task tree; the pool's threadCount - 1 workers plus thread 0 itself execute it,
+    // so the remaining benchmark threads have nothing to do.
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>&, int thread_id) override {
+        if (thread_id == 0) {
+            tasks = 0;
+            sortTask(inputData[0], 0, dataSize, 2 * std::bit_width(static_cast<unsigned long long>(dataSize)));
+        }
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>& inputData, int, long long) override {
+        metrics["tasks"] = tasks.load();
+        return {inputData[0]}; // sorted in place, nothing to merge
+    }
+
+    void sortTask(int* data, long long start, long long end, int depthLimit) {
+        tasks.fetch_add(1, std::memory_order_relaxed);
+        if (end - start <= grainSize || depthLimit == 0) {
+            sortRange(data, start, end, depthLimit);
+            return;
+        }
+        int pivot = medianOfThree(data, start, end);
+        auto partition = [&](auto predicate) {
+            return end - start >= parallelPartitionSize ? parallelPartition(data, start, end, predicate)
+                                                        : std::partition(data + start, data + end, predicate) - data;
+        };
+        long long split = partition([pivot](int key) { return key < pivot; });
+        if (split == start) {
+            // The pivot is the minimum: peel off the keys equal to it, which are already in final position
+            start = partition([pivot](int key) { return key <= pivot; });
+            sortTask(data, start, end, depthLimit - 1);
+            return;
+        }
+        ThreadPool::TaskGroup group(pool());
+        group.run([=, this]() { sortTask(data, start, split, depthLimit - 1); });
+        sortTask(data, split, end, depthLimit - 1);
+        group.wait();
+    }
+
+    static int medianOfThree(const int* data, long long start, long long end) {
+        int a = data[start];
+        int b = data[start + (end - start) / 2];
+        int c = data[end - 1];
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    // Block-based in-place parallel partition. Every chunk partitions itself; the global split point follows from
+    // the per-chunk counts. Keys failing the predicate left of the split and keys passing it right of the split
+    // are equally many, and the pool swaps them pairwise in parallel.
+    template <typename Predicate>
+    long long parallelPartition(int* data, long long start, long long end, Predicate predicate) {
+        int chunks = pool().size() + 1;
+        std::vector<long long> chunkStart(chunks + 1), chunkSplit(chunks);
+        pool().parallelFor(start, end, [&](int chunk, long long first, long long last) {
+            chunkStart[chunk] = first;
+            chunkSplit[chunk] = std::partition(data + first, data + last, predicate) - data;
+            if (chunk == chunks - 1) {
+                chunkStart[chunks] = last;
+            }
+        }, chunks);
+
+        long long split = start;
+        for (int c = 0; c < chunks; ++c) {
+            split += chunkSplit[c] - chunkStart[c];
+        }
+
+        // Misplaced intervals: failing keys inside [start, split) and passing keys inside [split, end)
+        std::vector<std::pair<long long, long long>> wrongLeft, wrongRight;
+        for (int c = 0; c < chunks; ++c) {
+            long long failFirst = chunkSplit[c], failLast = std::min(chunkStart[c + 1], split);
+            if (failFirst < failLast) {
+                wrongLeft.emplace_back(failFirst, failLast);
+            }
+            long long passFirst = std::max(chunkStart[c], split), passLast = chunkSplit[c];
+            if (passFirst < passLast) {
+                wrongRight.emplace_back(passFirst, passLast);
+            }
+        }
+        long long misplaced = 0;
+        for (const auto& [first, last] : wrongLeft) {
+            misplaced += last - first;
+        }
+        // Interval holding the rank-th misplaced key, and that key's position
+        auto locate = [](const std::vector<std::pair<long long, long long>>& intervals, long long rank) {
+            size_t interval = 0;
+            while (rank >= intervals[interval].second - intervals[interval].first) {
+                rank -= intervals[interval].second - intervals[interval].first;
+                ++interval;
+            }
+            return std::pair<size_t, long long>(interval, intervals[interval].first + rank);
+        };
+        pool().parallelFor(0, misplaced, [&](int, long long first, long long last) {
+            if (first == last) {
+                return;
+            }
+            auto [leftInterval, left] = locate(wrongLeft, first);
+            auto [rightInterval, right] = locate(wrongRight, first);
+            for (long long k = first; k < last; ++k) {
+                std::swap(data[left], data[right]);
+                if (++left == wrongLeft[leftInterval].second && ++leftInterval < wrongLeft.size()) {
+                    left = wrongLeft[leftInterval].first;
+                }
+                if (++right == wrongRight[rightInterval].second && ++rightInterval < wrongRight.size()) {
+                    right = wrongRight[rightInterval].first;
+                }
+            }
+        }, chunks);
+        return split;
+    }
+};
+
+// Sorts 256-key blocks with the bitonic network, then merges them bottom-up between the segment and a buffer
+class SimdSort : public SortingAlgorithm {
+public:
+    SimdSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SimdSort";
+    }
+
+protected:
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        metrics["simd"] = simdLevelName(networkLevel());
+        return SortingAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        const long long length = end - start;
+        const SimdLevel level = networkLevel();
+        for (long long block = start; block < end; block += BitonicNetwork::maxSize) {
+            sortSmallBlock(data + block, std::min<long long>(BitonicNetwork::maxSize, end - block), level);
+        }
+        if (length <= BitonicNetwork::maxSize) {
+            return;
+        }
+        std::vector<int> buffer(length);
+        int* source = data + start;
+        int* destination = buffer.data();
+        for (long long width = BitonicNetwork::maxSize; width < length; width *= 2) {
+            for (long long left = 0; left < length; left += 2 * width) {
+                long long middle = std::min(left + width, length);
+                long long right = std::min(left + 2 * width, length);
+                std::merge(source + left, source + middle, source + middle, source + right, destination + left);
+            }
+            std::swap(source, destination);
+        }
+        if (source != data + start) {
+            std::copy(source, source + length, data + start);
+        }
+    }
+};
+
+class InsertionSort : public SortingAlgorithm {
+public:
+    InsertionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "InsertionSort";
+    }
+
+protected:
+    void sortSegment(int* data, long long start, long long end) override {
+        for (long long i = start + 1; i < end; ++i) {
+            int key = data[i];
+            long long j = i - 1;
+            while (j >= start && data[j] > key) {
+                data[j + 1] = data[j];
+                --j;
+            }
+            data[j + 1] = key;
+        }
+    }
+};
+
+// Shell sort: insertion sort over a shrinking sequence of gaps, ending with gap 1.
+class ShellSort : public InsertionSort {
+public:
+    ShellSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : InsertionSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "ShellSort";
+    }
+
+    // Gaps below n, largest first
+    static std::vector<long long> gaps(GapSequence sequence, long long n) {
+        std::vector<long long> result;
+        switch (sequence) {
+            case GapSequence::Ciura: {
+                // Empirically best known prefix, extended geometrically by 2.25
+                double gap = 1;
+                for (long long g : {1, 4, 10, 23, 57, 132, 301, 701, 1750}) {
+                    if (g >= n) {
+                        break;
+                    }
+                    result.push_back(g);
+                    gap = static_cast<double>(g);
+                }
+                if (gap == 1750) {
+                    while ((gap *= 2.25) < static_cast<double>(n)) {
+                        result.push_back(static_cast<long long>(gap));
+                    }
+                }
+                break;
+            }
+            case GapSequence::Tokuda:
+                // ceil(h_k) with h_k = 2.25 * h_(k-1) + 1: 1, 4, 9, 20, 46, 103, ...
+                for (double h = 1; std::ceil(h) < static_cast<double>(n); h = 2.25 * h + 1) {
+                    result.push_back(static_cast<long long>(std::ceil(h)));
+                }
+                break;
+            case GapSequence::Sedgewick:
+                // 1 and 4^k + 3 * 2^(k-1) + 1: 1, 8, 23, 77, 281, ...
+                if (n > 1) {
+                    result.push_back(1);
+                }
+                for (long long k = 1; k < 31; ++k) {
+                    long long g = (1LL << (2 * k)) + 3 * (1LL << (k - 1)) + 1;
+                    if (g >= n) {
+                        break;
+                    }
+                    result.push_back(g);
+                }
+                break;
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+protected:
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        metrics["gap_sequence"] = gapSequenceName(options.gapSequence);
+        return SortingAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        for (long long gap : gaps(options.gapSequence, end - start)) {
+            for (long long i = start + gap; i < end; ++i) {
+                int key = data[i];
+                long long j = i;
+                while (j - gap >= start && data[j - gap] > key) {
+                    data[j] = data[j - gap];
+                    j -= gap;
+                }
+                data[j] = key;
+            }
+        }
+    }
+};
+
+// Insertion sort that finds each slot with a binary search and opens it with one memmove,
+// so comparisons drop to O(n log n) and shifting runs at memory bandwidth.
+class BinaryInsertionSort : public InsertionSort {
+public:
+    BinaryInsertionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : InsertionSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "BinaryInsertionSort";
+    }
+
+protected:
+    void sortSegment(int* data, long long start, long long end) override {
+        for (long long i = start + 1; i < end; ++i) {
+            int key = data[i];
+            if (data[i - 1] <= key) {
+                continue;
+            }
+            int* slot = std::upper_bound(data + start, data + i, key); // upper bound keeps equal keys stable
+            std::memmove(slot + 1, slot, static_cast<size_t>(data + i - slot) * sizeof(int));
+            *slot = key;
+        }
+    }
+};
+
+
+class SelectionSort : public SortingAlgorithm {
+public:
+    SelectionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SelectionSort";
+    }
+
+protected:
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        metrics["simd"] = simdLevelName(networkLevel());
+        return SortingAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        SimdLevel level = networkLevel();
+        for (long long i = start; i < end - 1; ++i) {
+            long long minIndex = i + argMin(data + i, end - i, level);
+            std::swap(data[i], data[minIndex]);
+        }
+    }
+};
+
+// Selection sort over the whole array: each round every thread finds the minimum of its share of the unsorted
+// suffix, and the barrier's completion step reduces those candidates and swaps the winner into place.
+class ParallelSelectionSort : public SelectionSort {
+public:
+    ParallelSelectionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SelectionSort(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "ParallelSelectionSort";
+    }
+
+protected:
+    struct alignas(64) Candidate {
+        int value = INT_MAX;
+        long long index = -1; // -1 when the thread's share was empty
+    };
+
+    struct RoundCompletion {
+        ParallelSelectionSort* self;
+        void operator()() noexcept {
+            int* data = self->sharedData;
+            long long best = -1;
+            for (const Candidate& candidate : self->candidates) {
+                if (candidate.index >= 0 && (best < 0 || candidate.value < data[best])) {
+                    best = candidate.index;
+                }
+            }
+            std::swap(data[self->round], data[best]);
+            ++self->round;
+        }
+    };
+
+    std::unique_ptr<std::barrier<RoundCompletion>> roundBarrier;
+    std::vector<Candidate> candidates;
+    int* sharedData = nullptr;
+    long long round = 0;
+    std::atomic<long long> barrierWaitNs{0};
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = SelectionSort::generateData(dataSize);
+        roundBarrier = std::make_unique<std::barrier<RoundCompletion>>(threadCount, RoundCompletion{this});
+        candidates.assign(threadCount, Candidate{});
+        sharedData = data[0];
+        round = 0;
+        barrierWaitNs = 0;
+        return data;
+    }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>&, int thread_id) override {
+        const int* data = inputData[0];
+        SimdLevel level = networkLevel();
+        long long waited = 0;
+        for (long long first = 0; first < dataSize - 1; ++first) {
+            long long remaining = dataSize - first;
+            long long lo = first + remaining * thread_id / threadCount;
+            long long hi = first + remaining * (thread_id + 1) / threadCount;
+            Candidate& mine = candidates[thread_id];
+            mine.index = lo < hi ? lo + argMin(data + lo, hi - lo, level) : -1;
+            mine.value = lo < hi ? data[mine.index] : INT_MAX;
+
+            auto arrived = std::chrono::steady_clock::now();
+            roundBarrier->arrive_and_wait();
+            waited += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - arrived).count();
+        }
+        barrierWaitNs.fetch_add(waited, std::memory_order_relaxed);
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>& inputData, int thread_count, long long) override {
+        metrics["simd"] = simdLevelName(networkLevel());
+        metrics["rounds"] = round;
+        metrics["barrier_wait_ns_per_round"] = round > 0 ? static_cast<double>(barrierWaitNs.load()) / (static_cast<double>(round) * thread_count) : 0.0;
+        return {inputData[0]}; // sorted in place, nothing to merge
+    }
+};
+
+
+class HeapSort : public SortingAlgorithm {
+public:
+    HeapSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "HeapSort";
+    }
+
+protected:
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        metrics["heap_arity"] = options.heapArity;
+        metrics["sift"] = options.floydSift ? "floyd" : "top_down";
+        metrics["sift_form"] = iterativeMode() ? "loop" : "recursive";
+        return SortingAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    void sortSegment(int* data, long long start, long long end) override {
+        switch (options.heapArity) {
+            case 4: sortInPlace<4>(data + start, end - start); break;
+            case 8: sortInPlace<8>(data + start, end - start); break;
+            default: sortInPlace<2>(data + start, end - start); break;
+        }
+    }
+
+    // Sorts keys[0, n) in place. Node i's children are heap[Arity * i + 1 .. Arity * i + Arity]; the heap
+    // starts a few keys into the segment so every sibling group shares one cache line.
+    template <int Arity>
+    void sortInPlace(int* keys, long long n) {
+        long long pad = alignmentPad<Arity>(keys);
+        if (n <= pad + 1) {
+            std::sort(keys, keys + n);
+            return;
+        }
+        if (pad > 0) {
+            // The skipped prefix must hold the smallest keys so it is already in final position
+            std::nth_element(keys, keys + pad, keys + n);
+            std::sort(keys, keys + pad);
+        }
+
+        int* heap = keys + pad;
+        long long size = n - pad;
+        for (long long i = (size - 2) / Arity; i >= 0; --i) {
+            siftDown<Arity>(heap, size, i, heap[i]);
+        }
+        for (long long last = size - 1; last > 0; --last) {
+            int value = heap[last];
+            heap[last] = heap[0];
+            siftDown<Arity>(heap, last, 0, value);
+        }
+    }
+
+    // Places value at hole and restores the heap below it: Floyd's method unless --heap-sift=top_down,
+    // each as a recursion or a loop depending on the iterative flag
+    template <int Arity>
+    void siftDown(int* heap, long long size, long long hole, int value) const {
+        bool loop = iterativeMode();
+        if (options.floydSift) {
+            long long leaf = loop ? descendToLeaf<Arity>(heap, size, hole) : descendToLeafRecursive<Arity>(heap, size, hole);
+            siftUp<Arity>(heap, hole, leaf, value);
+        } else {
+            heap[hole] = value;
+            if (loop) {
+                heapifyIterative<Arity>(heap, size, hole);
+            } else {
+                heapify<Arity>(heap, size, hole);
+            }
+        }
+    }
+
+    // Keys to skip so that heap + 1 (the first sibling group) sits on an Arity * sizeof(int) boundary.
+    // Groups of 2, 4 and 8 ints then never straddle a 64-byte line.
+    template <int Arity>
+    static long long alignmentPad(const int* keys) {
+        constexpr std::uintptr_t groupBytes = Arity * sizeof(int);
+        auto firstChild = reinterpret_cast<std::uintptr_t>(keys + 1);
+        return static_cast<long long>(((groupBytes - firstChild % groupBytes) % groupBytes) / sizeof(int));
+    }
+
+    template <int Arity>
+    static long long largestChild(const int* heap, long long first, long long size) {
+        long long last = std::min(first + Arity, size);
+        long long largest = first;
+        for (long long c = first + 1; c < last; ++c) {
+            largest = heap[c] > heap[largest] ? c : largest;
+        }
+        return largest;
+    }
+
+    // Floyd's sift-down: walk the hole to a leaf along the larger children without comparing against
+    // value, then sift value back up. Saves roughly one comparison per level, since value usually lands near the bottom.
+    // Both descents return the leaf the hole ended at.
+    template <int Arity>
+    static long long descendToLeaf(int* heap, long long size, long long hole) {
+        long long first;
+        while ((first = Arity * hole + 1) < size) {
+            long long largest = largestChild<Arity>(heap, first, size);
+            heap[hole] = heap[largest];
+            hole = largest;
+        }
+        return hole;
+    }
+
+    template <int Arity>
+    static long long descendToLeafRecursive(int* heap, long long size, long long hole) {
+        long long first = Arity * hole + 1;
+        if (first >= size) {
+            return hole;
+        }
+        long long largest = largestChild<Arity>(heap, first, size);
+        heap[hole] = heap[largest];
+        return descendToLeafRecursive<Arity>(heap, size, largest);
+    }
+
+    // Moves value up from hole towards top until its parent is not smaller
+    template <int Arity>
+    static void siftUp(int* heap, long long top, long long hole, int value) {
+        while (hole > top) {
+            long long parent = (hole - 1) / Arity;
+            if (heap[parent] >= value) {
+                break;
+            }
+            heap[hole] = heap[parent];
+            hole = parent;
+        }
+        heap[hole] = value;
+    }
+
+    template <int Arity>
+    static void heapify(int* heap, long long size, long long i) {
+        long long first = Arity * i + 1;
+        if (first >= size) {
+            return;
+        }
+        long long largest = largestChild<Arity>(heap, first, size);
+        if (heap[largest] > heap[i]) {
+            std::swap(heap[i], heap[largest]);
+            heapify<Arity>(heap, size, largest);  // Continue to heapify the subtree
+        }
+    }
+
+    // Loop form of heapify: follows the larger child down until the heap property holds
+    template <int Arity>
+    static void heapifyIterative(int* heap, long long size, long long i) {
+        long long first;
+        while ((first = Arity * i + 1) < size) {
+            long long largest = largestChild<Arity>(heap, first, size);
+            if (heap[largest] <= heap[i]) {
+                return;
+            }
+            std::swap(heap[i], heap[largest]);
+            i = largest;
+        }
+    }
+};
+
+// ===================== Partial sorts =====================
+// Algorithms that only need part of the order: the k largest keys, or the key of rank k. They reuse the sort key
+// generation; k comes from --k as a count or as a percentage of the data size.
+class PartialSortAlgorithm : public SortingAlgorithm {
+public:
+    PartialSortAlgorithm(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "PartialSortAlgorithm";
+    }
+
+protected:
+    long long k = 1;
+    std::chrono::steady_clock::time_point started;
+
+    std::vector<int*> generateData(long long dataSize) override {
+        k = options.selectCount > 0 ? options.selectCount : static_cast<long long>(std::ceil(static_cast<double>(dataSize) * options.selectFraction));
+        k = std::clamp(k, 1LL, dataSize);
+        return SortingAlgorithm::generateData(dataSize);
+    }
+
+    // The input is only read, so the permutation fingerprint of the base class is not needed
+    void prepare_test_result(const std::vector<int*>&, long long) override {}
+
+    // Partial algorithms never sort whole slices
+    void sortSegment(int* data, long long start, long long end) override {
+        std::sort(data + start, data + end);
+    }
 
-        for (auto& partial_result : result) {
-            if (!partial_result.empty() && partial_result[0] != nullptr) {
-                delete[] partial_result[0]; // Deallocate each partial result
-                partial_result[0] = nullptr;
+    void startClock(int thread_id) {
+        if (thread_id == 0) {
+            started = std::chrono::steady_clock::now();
+        }
+    }
+
+    void recordThroughput(long long data_size) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+        metrics["k"] = k;
+        metrics["keys_per_second"] = elapsed.count() > 0 ? static_cast<double>(data_size) / elapsed.count() : 0.0;
+    }
+
+    // Counts of input keys below and at or below value, computed on the pool
+    std::pair<long long, long long> rankOf(const int* data, long long data_size, int value) {
+        std::vector<long long> below(pool().size() + 1, 0);
+        std::vector<long long> atOrBelow(pool().size() + 1, 0);
+        pool().parallelFor(0, data_size, [&](int chunk, long long first, long long last) {
+            for (long long i = first; i < last; ++i) {
+                below[chunk] += data[i] < value;
+                atOrBelow[chunk] += data[i] <= value;
+            }
+        });
+        return {std::accumulate(below.begin(), below.end(), 0LL), std::accumulate(atOrBelow.begin(), atOrBelow.end(), 0LL)};
+    }
+};
+
+// Top-k: every thread keeps the k largest keys of its slice in a bounded min-heap, and the T candidate sets
+// are reduced to the overall k largest at the end. Output is those keys in descending order.
+class TopK : public PartialSortAlgorithm {
+public:
+    TopK(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : PartialSortAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "TopK";
+    }
+
+protected:
+    std::vector<std::vector<int>> heaps;
+    std::vector<int> topK;
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = PartialSortAlgorithm::generateData(dataSize);
+        heaps.assign(threadCount, {});
+        return data;
+    }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>&, int thread_id) override {
+        startClock(thread_id);
+        const int* data = inputData[0];
+        long long first = area_of_responsibility[0];
+        long long last = area_of_responsibility[1];
+        long long capacity = std::min(k, last - first);
+        std::vector<int>& heap = heaps[thread_id];
+        heap.assign(data + first, data + first + capacity);
+        std::make_heap(heap.begin(), heap.end(), std::greater<>());
+        for (long long i = first + capacity; i < last; ++i) {
+            // Almost every key loses against the heap's minimum once the heap has warmed up
+            if (data[i] > heap.front()) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                heap.back() = data[i];
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
             }
         }
+        return {};
+    }
 
-        result.clear();
-        data.clear();
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int, long long data_size) override {
+        topK.clear();
+        for (const auto& heap : heaps) {
+            topK.insert(topK.end(), heap.begin(), heap.end());
+        }
+        std::nth_element(topK.begin(), topK.begin() + (k - 1), topK.end(), std::greater<>());
+        topK.resize(k);
+        std::sort(topK.begin(), topK.end(), std::greater<>());
+        recordThroughput(data_size);
+        return {topK.data()};
     }
 
-    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
-        if (verbose) {
-            std::cout << "Merging partial results from threads." << std::endl;
+    // Descending, and exactly the input's keys above the smallest returned key plus enough copies of that key
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        const int* top = result[0];
+        if (!std::is_sorted(top, top + k, std::greater<>())) {
+            std::cout << "Top-k failed: result is not in descending order." << std::endl;
+            return false;
+        }
+        int threshold = top[k - 1];
+        auto [below, atOrBelow] = rankOf(input_data[0], dataSize, threshold);
+        long long above = dataSize - atOrBelow;
+        long long returnedAbove = std::count_if(top, top + k, [threshold](int key) { return key > threshold; });
+        if (returnedAbove != above || dataSize - below < k) {
+            std::cout << "Top-k failed: " << above << " keys exceed " << threshold << " but " << returnedAbove << " were returned." << std::endl;
+            return false;
+        }
+        std::vector<uint64_t> partial(pool().size() + 1, 0);
+        pool().parallelFor(0, dataSize, [&](int chunk, long long first, long long last) {
+            for (long long i = first; i < last; ++i) {
+                partial[chunk] += input_data[0][i] > threshold ? mixKey(input_data[0][i], 0) : 0;
+            }
+        });
+        uint64_t expected = std::accumulate(partial.begin(), partial.end(), uint64_t{0});
+        uint64_t returned = 0;
+        for (long long i = 0; i < returnedAbove; ++i) {
+            returned += mixKey(top[i], 0);
+        }
+        if (returned != expected) {
+            std::cout << "Top-k failed: returned keys are not the largest keys of the input." << std::endl;
+            return false;
         }
+        return true;
+    }
+};
 
-        // Allocate space for the merged data
-        auto* merged_data = new int[data_size];
-        std::vector<long long> start(thread_count), end(thread_count), indexes(thread_count);
+// Selection of the key of rank k (k-th smallest, 1-based; --k=50% is the median). Each round samples the current
+// range, picks two pivots that bracket the target rank in the sample, counts the keys below, between and above
+// them in parallel, and moves only the bucket holding the target into a buffer. Small ranges finish with nth_element.
+class ParallelSelect : public PartialSortAlgorithm {
+public:
+    ParallelSelect(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : PartialSortAlgorithm(threadCount, dataSize, verbose, reiterative) {}
 
-        for (int i = 0; i < thread_count; ++i) {
-            auto area_of_responsibility = calculate_area_of_responsibility(i, thread_count, data_size);
-            start[i] = area_of_responsibility[0];
-            end[i] = area_of_responsibility[1];
-            indexes[i] = start[i];
+    [[nodiscard]] std::string getType() const override {
+        return "ParallelSelect";
+    }
+
+protected:
+    static constexpr long long serialCutoff = 1 << 15;
+    static constexpr long long sampleSize = 1 << 12;
+
+    std::unique_ptr<int[]> buffers[2];
+    std::vector<long long> counts;     // counts[t * 3 + bucket]
+    const int* source = nullptr;       // current candidate range, shared by all threads
+    long long rangeBegin = 0;
+    long long rangeEnd = 0;
+    long long rank = 0;                // target rank inside the current range, 0-based
+    int pivots[2] = {0, 0};
+    int round = 0;
+    bool finished = false;
+    int answer = 0;
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = PartialSortAlgorithm::generateData(dataSize);
+        buffers[0].reset(new int[dataSize]);
+        buffers[1].reset(new int[dataSize]);
+        counts.assign(static_cast<size_t>(threadCount) * 3, 0);
+        return data;
+    }
+
+    static int bucketOf(int key, const int* pivots) {
+        return (key >= pivots[0]) + (key > pivots[1]);
+    }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>& inputData,
+        std::atomic<bool>&, std::barrier<>& sync_point, int thread_id) override {
+        startClock(thread_id);
+        if (thread_id == 0) {
+            source = inputData[0];
+            rangeBegin = 0;
+            rangeEnd = dataSize;
+            rank = k - 1;
+            round = 0;
+            finished = false;
         }
+        sync_point.arrive_and_wait();
 
-        int merged_index = 0;
+        std::mt19937 gen(std::random_device{}());
         while (true) {
-            int min_value = INT_MAX;
-            int min_index = -1;
+            if (thread_id == 0) {
+                chooseRound(gen);
+            }
+            sync_point.arrive_and_wait();
+            if (finished) {
+                return {};
+            }
+
+            long long size = rangeEnd - rangeBegin;
+            long long first = rangeBegin + size * thread_id / threadCount;
+            long long last = rangeBegin + size * (thread_id + 1) / threadCount;
+            long long* mine = counts.data() + static_cast<size_t>(thread_id) * 3;
+            std::fill(mine, mine + 3, 0);
+            for (long long i = first; i < last; ++i) {
+                ++mine[bucketOf(source[i], pivots)];
+            }
+            sync_point.arrive_and_wait();
+
+            // Every thread derives the target bucket and its own write offset from the same counts
+            long long totals[3] = {0, 0, 0};
+            long long before = 0;
+            for (int t = 0; t < threadCount; ++t) {
+                for (int b = 0; b < 3; ++b) {
+                    totals[b] += counts[static_cast<size_t>(t) * 3 + b];
+                }
+            }
+            int target = rank < totals[0] ? 0 : rank < totals[0] + totals[1] ? 1 : 2;
+            for (int t = 0; t < thread_id; ++t) {
+                before += counts[static_cast<size_t>(t) * 3 + target];
+            }
+            int* destination = buffers[round % 2].get();
+            for (long long i = first; i < last; ++i) {
+                if (bucketOf(source[i], pivots) == target) {
+                    destination[before++] = source[i];
+                }
+            }
+            sync_point.arrive_and_wait();
 
-            // Find the smallest element among the threads
-            for (int i = 0; i < thread_count; ++i) {
-                if (indexes[i] < end[i] && inputData[0][indexes[i]] < min_value) {
-                    min_value = inputData[0][indexes[i]];
-                    min_index = i;
+            if (thread_id == 0) {
+                rank -= target > 0 ? totals[0] : 0;
+                rank -= target > 1 ? totals[1] : 0;
+                if (target == 1 && pivots[0] == pivots[1]) {
+                    finished = true; // the bucket holds only copies of the pivot
+                    answer = pivots[0];
+                } else if (totals[target] == size) {
+                    serialFinish(); // no progress, e.g. the range holds very few distinct keys
+                } else {
+                    source = destination;
+                    rangeBegin = 0;
+                    rangeEnd = totals[target];
                 }
+                ++round;
             }
+            sync_point.arrive_and_wait();
+        }
+    }
 
-            if (min_index == -1) break; // No more elements to merge
-            merged_data[merged_index++] = min_value;
-            indexes[min_index]++;
+    // Run by thread 0 between rounds: finish small ranges serially, otherwise pick the pivots for the next round
+    void chooseRound(std::mt19937& gen) {
+        if (finished) {
+            return;
+        }
+        long long size = rangeEnd - rangeBegin;
+        if (size <= serialCutoff) {
+            serialFinish();
+            return;
         }
+        std::uniform_int_distribution<long long> pick(rangeBegin, rangeEnd - 1);
+        std::vector<int> sample(sampleSize);
+        for (int& key : sample) {
+            key = source[pick(gen)];
+        }
+        std::sort(sample.begin(), sample.end());
+        // Bracket the target's expected sample position by a few standard deviations so it usually lands in the middle bucket
+        double position = static_cast<double>(rank) / static_cast<double>(size) * sampleSize;
+        double spread = 2.0 * std::sqrt(static_cast<double>(sampleSize));
+        auto at = [&](double p) { return sample[static_cast<size_t>(std::clamp(p, 0.0, static_cast<double>(sampleSize - 1)))]; };
+        pivots[0] = at(position - spread);
+        pivots[1] = at(position + spread);
+    }
 
-        if (verbose) {
-            std::cout << "Merged data successfully." << std::endl;
+    void serialFinish() {
+        long long size = rangeEnd - rangeBegin;
+        int* scratch = buffers[round % 2].get();
+        if (source != scratch) {
+            std::copy(source + rangeBegin, source + rangeEnd, scratch); // never reorder the caller's input
         }
+        std::nth_element(scratch, scratch + rank, scratch + size);
+        answer = scratch[rank];
+        finished = true;
+    }
 
-        return {merged_data}; // Return the merged data
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int, long long data_size) override {
+        metrics["rounds"] = round;
+        recordThroughput(data_size);
+        return {&answer};
     }
 
     bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
-        const int* sorted_data = result[0]; // Assuming the sorted result is stored in the first element
-        for (long long i = 1; i < dataSize; ++i) {
-            if (sorted_data[i - 1] > sorted_data[i]) {
-                std::cout << "Sorting failed at index " << i << ": " << sorted_data[i - 1] << " > " << sorted_data[i] << std::endl;
-                return false;
-            }
+        int value = result[0][0];
+        auto [below, atOrBelow] = rankOf(input_data[0], dataSize, value);
+        if (below >= k || atOrBelow < k) {
+            std::cout << "Selection failed: " << value << " has rank [" << below + 1 << ", " << atOrBelow << "], expected " << k << "." << std::endl;
+            return false;
         }
         return true;
     }
+};
 
-    std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>&  stopFlag) override {
-        int* data = inputData[0]; // Access the data
-        long long start = area_of_responsibility[0];
-        long long end = area_of_responsibility[1];
-        sortSegment(data, start, end);
-        return {}; // Sorting is in-place; no need to return data here
+// ===================== ExternalSort =====================
+// Out-of-core sort for inputs larger than memory. The input is generated block by block into a file. All threads
+// then read chunks that together fit in --memory-mb, sort them and write them back as runs. Thread 0 merges the runs
+// in batches on the pool: a batch takes every key up to the smallest last key among the runs' buffered blocks, so
+// nothing outside the buffers can precede it. The next block of every run and the previous batch's output are read
+// and written asynchronously while a batch merges. Bytes moved and time spent waiting on I/O are reported per phase.
+class ExternalSort : public SortingAlgorithm {
+public:
+    ExternalSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "ExternalSort";
+    }
+
+protected:
+    static constexpr long long generateBlock = 1 << 20;
+    static constexpr long long minimumBlock = 1 << 12;
+
+    struct PhaseIo {
+        std::atomic<long long> bytesRead = 0;
+        std::atomic<long long> bytesWritten = 0;
+        std::atomic<long long> waitNs = 0;
+        double seconds = 0;
+
+        [[nodiscard]] nlohmann::json toJson() const {
+            return {{"bytes_read", bytesRead.load()}, {"bytes_written", bytesWritten.load()},
+                    {"io_wait_seconds", static_cast<double>(waitNs.load()) * 1e-9}, {"seconds", seconds}};
+        }
+    };
+
+    std::unique_ptr<BlockFile> input;   // generated keys, later overwritten by the sorted runs
+    std::unique_ptr<BlockFile> output;
+    PhaseIo runIo;
+    PhaseIo mergeIo;
+    long long chunkKeys = 0;
+    long long runCount = 0;
+
+    [[nodiscard]] long long memoryKeys() const {
+        return options.externalMemoryMb * (1LL << 20) / static_cast<long long>(sizeof(int));
+    }
+
+    static std::filesystem::path scratchFile(const std::filesystem::path& directory, const char* role) {
+        static std::atomic<int> counter = 0;
+        return directory / ("external-sort-" + std::to_string(counter++) + "-" + std::to_string(std::random_device{}()) + "-" + role + ".bin");
+    }
+
+    // Runs fn and charges the time it blocks the calling thread to phase
+    template <class Fn>
+    static auto waitFor(PhaseIo& phase, Fn&& fn) {
+        auto begin = std::chrono::steady_clock::now();
+        struct Charge {
+            PhaseIo& phase;
+            std::chrono::steady_clock::time_point begin;
+            ~Charge() {
+                phase.waitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            }
+        } charge{phase, begin};
+        return fn();
     }
 
     std::vector<int*> generateData(long long dataSize) override {
-        auto* data = new int[dataSize]; // Dynamically allocate array
+        std::filesystem::path directory = options.externalDirectory.empty() ? std::filesystem::temp_directory_path()
+                                                                           : std::filesystem::path(options.externalDirectory);
+        input = std::make_unique<BlockFile>(scratchFile(directory, "input"));
+        output = std::make_unique<BlockFile>(scratchFile(directory, "output"));
+        if (options.verifyResults) {
+            fingerprintSeed = std::random_device{}() * 0x100000001b3ULL ^ std::random_device{}();
+            inputFingerprint = 0;
+        }
+        // Distributions with structure (nearly sorted, runs) are applied per generated block
         std::random_device rd;
         std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 1000);
-        for (long long i = 0; i < dataSize; ++i) {
-            data[i] = dis(gen);
+        const int* source = options.datasetPath.empty() ? nullptr : loadDataset(dataSize);
+        std::vector<int> block(std::min(generateBlock, dataSize));
+        for (long long position = 0; position < dataSize; position += generateBlock) {
+            long long count = std::min(generateBlock, dataSize - position);
+            if (source != nullptr) {
+                std::copy(source + position, source + position + count, block.begin());
+            } else {
+                generateKeys(block.data(), count, gen);
+            }
+            if (options.verifyResults) {
+                for (long long i = 0; i < count; ++i) {
+                    inputFingerprint += mixKey(block[i], fingerprintSeed);
+                }
+            }
+            input->write(block.data(), count, position);
         }
-        return {data}; // Return the generated data as a vector containing a pointer
+        dataset.reset(); // the keys now live in the input file
+        chunkKeys = std::max(minimumBlock, memoryKeys() / threadCount); // set here, before the workers read them
+        runCount = (dataSize + chunkKeys - 1) / chunkKeys;
+        return {};
     }
 
-    std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) override {
-        long long segmentSize = dataSize / maxThreads;
-        return {currentThread * segmentSize, (currentThread == maxThreads - 1) ? dataSize : (currentThread + 1) * segmentSize};
+    // The input is a file rather than an int array
+    [[nodiscard]] std::pair<long long, long long> inputShape(long long) const override {
+        return {0, 0};
     }
 
-    virtual void sortSegment(int* data, long long start, long long end) = 0;
-};
+    // The fingerprint is taken while the input is generated
+    void prepare_test_result(const std::vector<int*>&, long long) override {}
 
+    void sortSegment(int* data, long long start, long long end) override {
+        PdqSortKernel::sort(data + start, data + end);
+    }
 
-// ===================== Algorithms =====================
-class BubbleSort : public SortingAlgorithm {
-public:
-    BubbleSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    std::vector<int*> executeCooperative(const std::vector<long long>&, const std::vector<int*>&,
+        std::atomic<bool>&, std::barrier<>& sync_point, int thread_id) override {
+        auto phaseStart = std::chrono::steady_clock::now();
 
-    [[nodiscard]] std::string getType() const override {
-        return "BubbleSort";
+        // Run formation: chunk r goes to thread r mod T and is written back in place as run r
+        std::unique_ptr<int[]> chunk(new int[std::min(chunkKeys, dataSize)]);
+        for (long long run = thread_id; run < runCount; run += threadCount) {
+            long long first = run * chunkKeys;
+            long long count = std::min(chunkKeys, dataSize - first);
+            waitFor(runIo, [&]() { input->read(chunk.get(), count, first); });
+            runIo.bytesRead += count * static_cast<long long>(sizeof(int));
+            sortSegmentCounted(chunk.get(), 0, count);
+            waitFor(runIo, [&]() { input->write(chunk.get(), count, first); });
+            runIo.bytesWritten += count * static_cast<long long>(sizeof(int));
+        }
+        chunk.reset();
+        sync_point.arrive_and_wait();
+        if (thread_id != 0) {
+            return {};
+        }
+        runIo.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - phaseStart).count();
+
+        phaseStart = std::chrono::steady_clock::now();
+        mergeRuns();
+        mergeIo.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - phaseStart).count();
+        return {};
     }
 
-protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        for (long long i = start; i < end - 1; ++i) {
-            for (long long j = start; j < end - 1 - (i - start); ++j) {
-                if (data[j] > data[j + 1]) {
-                    std::swap(data[j], data[j + 1]);
+    struct RunReader {
+        long long next = 0;   // file position of the next block to fetch
+        long long end = 0;
+        std::vector<int> block;
+        long long consumed = 0;
+        std::future<std::vector<int>> pending;
+    };
+
+    std::future<std::vector<int>> fetch(RunReader& reader, long long blockKeys) {
+        long long position = reader.next;
+        long long count = std::min(blockKeys, reader.end - position);
+        reader.next += count;
+        return std::async(std::launch::async, [this, position, count]() {
+            std::vector<int> block(count);
+            input->read(block.data(), count, position);
+            mergeIo.bytesRead += count * static_cast<long long>(sizeof(int));
+            return block;
+        });
+    }
+
+    void mergeRuns() {
+        // Two blocks per run (current and prefetched) plus two output batches of up to one block per run
+        long long blockKeys = std::max(minimumBlock, memoryKeys() / std::max(1LL, 4 * runCount));
+        std::vector<RunReader> readers(runCount);
+        for (long long run = 0; run < runCount; ++run) {
+            readers[run].next = run * chunkKeys;
+            readers[run].end = std::min(dataSize, (run + 1) * chunkKeys);
+            readers[run].pending = fetch(readers[run], blockKeys);
+        }
+        auto advance = [&](RunReader& reader) {
+            reader.block = waitFor(mergeIo, [&]() { return reader.pending.get(); });
+            reader.consumed = 0;
+            if (reader.next < reader.end) {
+                reader.pending = fetch(reader, blockKeys);
+            }
+        };
+        for (auto& reader : readers) {
+            advance(reader);
+        }
+
+        std::vector<int> batches[2];
+        std::future<void> writes[2];
+        long long written = 0;
+        for (int turn = 0;; turn ^= 1) {
+            bool anyLeft = false;
+            int bound = INT_MAX;
+            for (const auto& reader : readers) {
+                if (reader.consumed < static_cast<long long>(reader.block.size())) {
+                    anyLeft = true;
+                    bound = std::min(bound, reader.block.back());
+                }
+            }
+            if (!anyLeft) {
+                break;
+            }
+            std::vector<LoserTree::Run> runs;
+            long long total = 0;
+            for (const auto& reader : readers) {
+                const int* from = reader.block.data() + reader.consumed;
+                const int* to = std::upper_bound(from, reader.block.data() + static_cast<long long>(reader.block.size()), bound);
+                if (from < to) {
+                    runs.emplace_back(from, to);
+                    total += to - from;
+                }
+            }
+
+            if (writes[turn].valid()) {
+                waitFor(mergeIo, [&]() { writes[turn].get(); }); // this batch buffer is still being written
+            }
+            batches[turn].resize(total);
+            mergeRunsParallel(runs, total, batches[turn].data());
+            writes[turn] = std::async(std::launch::async, [this, &batch = batches[turn], written]() {
+                output->write(batch.data(), static_cast<long long>(batch.size()), written);
+                mergeIo.bytesWritten += static_cast<long long>(batch.size() * sizeof(int));
+            });
+            written += total;
+
+            for (size_t r = 0, used = 0; r < readers.size(); ++r) {
+                RunReader& reader = readers[r];
+                if (used < runs.size() && reader.block.data() + reader.consumed == runs[used].first) {
+                    reader.consumed += runs[used].second - runs[used].first;
+                    ++used;
+                }
+                if (reader.consumed == static_cast<long long>(reader.block.size()) && reader.pending.valid()) {
+                    advance(reader);
                 }
             }
         }
+        for (auto& write : writes) {
+            if (write.valid()) {
+                waitFor(mergeIo, [&]() { write.get(); });
+            }
+        }
     }
-};
 
-class QuickSort : public SortingAlgorithm {
-public:
-    QuickSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int, long long) override {
+        recordBranchMisses();
+        metrics["runs"] = runCount;
+        metrics["memory_mb"] = options.externalMemoryMb;
+        metrics["run_formation"] = runIo.toJson();
+        metrics["merge"] = mergeIo.toJson();
+        return {};
+    }
 
-    [[nodiscard]] std::string getType() const override {
-        return "QuickSort";
+    // Streams the output file back: ordered, and the same multiset fingerprint as the generated input
+    bool test_result(const std::vector<int*>&, const std::vector<int*>&, long long dataSize) override {
+        std::vector<int> block(std::min(generateBlock, dataSize));
+        uint64_t fingerprint = 0;
+        int previous = INT_MIN;
+        for (long long position = 0; position < dataSize; position += generateBlock) {
+            long long count = std::min(generateBlock, dataSize - position);
+            output->read(block.data(), count, position);
+            for (long long i = 0; i < count; ++i) {
+                if (block[i] < previous) {
+                    std::cout << "Sorting failed at index " << position + i << ": " << previous << " > " << block[i] << std::endl;
+                    return false;
+                }
+                previous = block[i];
+                fingerprint += mixKey(block[i], fingerprintSeed);
+            }
+        }
+        if (fingerprint != inputFingerprint) {
+            std::cout << "Sorting failed: output is not a permutation of the input." << std::endl;
+            return false;
+        }
+        return true;
     }
 
-protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        std::sort(data + start, data + end);
+    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
+        data.clear(); // the files are removed with the algorithm
+        result.clear();
     }
 };
 
+// ===================== RecordSortAlgorithm =====================
+// A sort key followed by PayloadBytes of payload. The first eight payload bytes hold the record's position in the
+// generated input and the rest are derived from it, so verification can see both reordered equal keys and torn moves.
+template <int PayloadBytes>
+struct Record {
+    int key;
+    unsigned char payload[PayloadBytes];
+};
+
+// Indirect mode sorts these (key, input position) pairs and gathers the records afterwards
+struct KeyIndex {
+    int key;
+    uint32_t index;
+};
 
-class MergeSort : public SortingAlgorithm {
+// Stable sorts of records with a payload size chosen at run time (--payload). Kernel provides
+//   template <class Item> Item* sortItems(Item* items, Item* scratch, std::barrier<>& sync_point, int thread_id),
+// which every thread runs and which returns whichever of the two arrays ends up sorted.
+template <class Kernel>
+class RecordSortAlgorithm : public Algorithm {
 public:
-    MergeSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    RecordSortAlgorithm(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : Algorithm(threadCount, dataSize, verbose, reiterative) {}
 
     [[nodiscard]] std::string getType() const override {
-        return "MergeSort";
+        return "RecordSortAlgorithm";
     }
 
 protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        if (end - start <= 1) return;
-        long long mid = start + (end - start) / 2;
-        sortSegment(data, start, mid);
-        sortSegment(data, mid, end);
+    std::unique_ptr<unsigned char[]> records;      // the generated input
+    std::unique_ptr<unsigned char[]> scratch;      // partner array of the kernel, or the gather target in indirect mode
+    std::unique_ptr<KeyIndex[]> keys;              // indirect mode only
+    std::unique_ptr<KeyIndex[]> keysScratch;
+    std::vector<int> inputKeys;                    // untimed copy of the input keys for verification
+    unsigned char* sorted = nullptr;
 
-        // Temporary array for merging
-        std::vector<int> temp(end - start);
-        std::merge(data + start, data + mid, data + mid, data + end, temp.begin());
-        std::copy(temp.begin(), temp.end(), data + start);
+    [[nodiscard]] long long recordBytes() const {
+        return static_cast<long long>(sizeof(int)) + options.recordPayload;
     }
-};
 
-class InsertionSort : public SortingAlgorithm {
-public:
-    InsertionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    // Calls body.template operator()<PayloadBytes>() for the configured payload size
+    template <class Body>
+    void withPayload(Body&& body) {
+        switch (options.recordPayload) {
+            case 8: body.template operator()<8>(); break;
+            case 16: body.template operator()<16>(); break;
+            case 24: body.template operator()<24>(); break;
+            case 32: body.template operator()<32>(); break;
+            case 40: body.template operator()<40>(); break;
+            case 48: body.template operator()<48>(); break;
+            case 56: body.template operator()<56>(); break;
+            case 64: body.template operator()<64>(); break;
+            default: throw std::invalid_argument("Record payload must be a multiple of 8 bytes between 8 and 64.");
+        }
+    }
 
-    [[nodiscard]] std::string getType() const override {
-        return "InsertionSort";
+    template <int P>
+    static Record<P>* recordsAt(unsigned char* bytes) {
+        static_assert(sizeof(Record<P>) == sizeof(int) + P, "records must be packed");
+        return reinterpret_cast<Record<P>*>(bytes);
     }
 
-protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        for (long long i = start + 1; i < end; ++i) {
-            int key = data[i];
-            long long j = i - 1;
-            while (j >= start && data[j] > key) {
-                data[j + 1] = data[j];
-                --j;
+    static unsigned char payloadByte(uint64_t position, int offset) {
+        return static_cast<unsigned char>(position * 131 + offset * 7);
+    }
+
+    template <int P>
+    static uint64_t positionOf(const Record<P>& record) {
+        uint64_t position;
+        std::memcpy(&position, record.payload, sizeof(position));
+        return position;
+    }
+
+    Kernel& kernel() {
+        return static_cast<Kernel&>(*this);
+    }
+
+    std::vector<int*> generateData(long long dataSize) override {
+        if (options.recordIndirect && dataSize > static_cast<long long>(UINT32_MAX)) {
+            throw std::invalid_argument("Indirect record sorting needs positions that fit in 32 bits.");
+        }
+        auto bytes = static_cast<size_t>(dataSize * recordBytes());
+        records.reset(new unsigned char[bytes]);
+        scratch.reset(new unsigned char[bytes]);
+        if (options.recordIndirect) {
+            keys.reset(new KeyIndex[dataSize]);
+            keysScratch.reset(new KeyIndex[dataSize]);
+        }
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> dis(options.sortKeyMin, options.sortKeyMax);
+        const int* source = options.datasetPath.empty() ? nullptr : loadDataset(dataSize); // keys only; payloads are always generated
+        withPayload([&]<int P>() {
+            Record<P>* items = recordsAt<P>(records.get());
+            for (long long i = 0; i < dataSize; ++i) {
+                auto position = static_cast<uint64_t>(i);
+                items[i].key = source != nullptr ? source[i] : dis(gen);
+                std::memcpy(items[i].payload, &position, sizeof(position));
+                for (int offset = sizeof(position); offset < P; ++offset) {
+                    items[i].payload[offset] = payloadByte(position, offset);
+                }
             }
-            data[j + 1] = key;
+        });
+        return {}; // records live in this object and are released with it
+    }
+
+    void prepare_test_result(const std::vector<int*>&, long long dataSize) override {
+        inputKeys.resize(dataSize);
+        withPayload([&]<int P>() {
+            const Record<P>* items = recordsAt<P>(records.get());
+            for (long long i = 0; i < dataSize; ++i) {
+                inputKeys[i] = items[i].key;
+            }
+        });
+    }
+
+    std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) override {
+        long long segmentSize = dataSize / maxThreads;
+        return {currentThread * segmentSize, (currentThread == maxThreads - 1) ? dataSize : (currentThread + 1) * segmentSize};
+    }
+
+    // Threads work on shared arrays in executeCooperative; there is no independent per-slice step
+    std::vector<int*> execute(const std::vector<long long>&, const std::vector<int*>&, std::atomic<bool>&) override {
+        return {};
+    }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>&,
+        std::atomic<bool>&, std::barrier<>& sync_point, int thread_id) override {
+        const long long first = area_of_responsibility[0];
+        const long long last = area_of_responsibility[1];
+        withPayload([&]<int P>() {
+            Record<P>* items = recordsAt<P>(records.get());
+            if (!options.recordIndirect) {
+                Record<P>* result = kernel().sortItems(items, recordsAt<P>(scratch.get()), sync_point, thread_id);
+                if (thread_id == 0) {
+                    sorted = reinterpret_cast<unsigned char*>(result);
+                }
+                return;
+            }
+            // Sort 8-byte (key, position) pairs, then move every record exactly once
+            for (long long i = first; i < last; ++i) {
+                keys[i] = {items[i].key, static_cast<uint32_t>(i)};
+            }
+            sync_point.arrive_and_wait();
+            const KeyIndex* order = kernel().sortItems(keys.get(), keysScratch.get(), sync_point, thread_id);
+            Record<P>* output = recordsAt<P>(scratch.get());
+            for (long long i = first; i < last; ++i) {
+                output[i] = items[order[i].index];
+            }
+            if (thread_id == 0) {
+                sorted = scratch.get();
+            }
+        });
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>&, int, long long) override {
+        metrics["payload_bytes"] = options.recordPayload;
+        metrics["record_bytes"] = recordBytes();
+        metrics["indirect"] = options.recordIndirect;
+        return {}; // the sorted records are at `sorted`
+    }
+
+    // Why record i is misplaced, or nullptr when it is fine
+    template <int P>
+    const char* recordFault(const Record<P>* items, long long i, long long dataSize) const {
+        uint64_t position = positionOf(items[i]);
+        if (position >= static_cast<uint64_t>(dataSize) || inputKeys[position] != items[i].key) {
+            return "record does not match any input record";
+        }
+        for (int offset = sizeof(position); offset < P; ++offset) {
+            if (items[i].payload[offset] != payloadByte(position, offset)) {
+                return "payload damaged";
+            }
+        }
+        if (i > 0 && items[i - 1].key > items[i].key) {
+            return "keys out of order";
+        }
+        if (i > 0 && items[i - 1].key == items[i].key && positionOf(items[i - 1]) >= position) {
+            return "equal keys lost their input order (unstable)";
+        }
+        return nullptr;
+    }
+
+    // Ordered by key, equal keys in input order (which also rules out duplicated records), payloads intact
+    bool test_result(const std::vector<int*>&, const std::vector<int*>&, long long dataSize) override {
+        const char* fault = nullptr;
+        long long faultIndex = 0;
+        withPayload([&]<int P>() {
+            const Record<P>* items = recordsAt<P>(sorted);
+            std::atomic<long long> firstFault = LLONG_MAX;
+            pool().parallelFor(0, dataSize, [&](int, long long first, long long last) {
+                for (long long i = first; i < last; ++i) {
+                    if (recordFault(items, i, dataSize) != nullptr) {
+                        long long seen = firstFault.load();
+                        while (i < seen && !firstFault.compare_exchange_weak(seen, i)) {}
+                        break;
+                    }
+                }
+            });
+            if (firstFault != LLONG_MAX) {
+                faultIndex = firstFault;
+                fault = recordFault(items, faultIndex, dataSize);
+            }
+        });
+        if (fault != nullptr) {
+            std::cout << "Record sort failed at index " << faultIndex << ": " << fault << std::endl;
+            return false;
         }
+        return true;
+    }
+
+    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
+        data.clear();
+        result.clear();
     }
 };
 
+// Each thread stable-sorts its slice, then the slices are merged pairwise. At every level each thread produces
+// its own share of the output, found in both input runs by merge-path co-ranking, so all threads stay busy.
+class RecordMergeSort : public RecordSortAlgorithm<RecordMergeSort> {
+    friend class RecordSortAlgorithm<RecordMergeSort>;
 
-class SelectionSort : public SortingAlgorithm {
 public:
-    SelectionSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    RecordMergeSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : RecordSortAlgorithm(threadCount, dataSize, verbose, reiterative) {}
 
     [[nodiscard]] std::string getType() const override {
-        return "SelectionSort";
+        return "RecordMergeSort";
     }
 
 protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        for (long long i = start; i < end - 1; ++i) {
-            long long minIndex = i;
-            for (long long j = i + 1; j < end; ++j) {
-                if (data[j] < data[minIndex]) {
-                    minIndex = j;
+    template <class Item>
+    Item* sortItems(Item* items, Item* scratch, std::barrier<>& sync_point, int thread_id) {
+        auto byKey = [](const Item& a, const Item& b) { return a.key < b.key; };
+        auto bound = [&](int slice) {
+            return slice >= threadCount ? dataSize : calculate_area_of_responsibility(slice, threadCount, dataSize)[0];
+        };
+        const long long first = bound(thread_id);
+        const long long last = bound(thread_id + 1);
+        std::stable_sort(items + first, items + last, byKey);
+        sync_point.arrive_and_wait();
+
+        Item* source = items;
+        Item* destination = scratch;
+        for (int width = 1; width < threadCount; width *= 2) {
+            for (int slice = 0; slice < threadCount; slice += 2 * width) {
+                long long runBegin = bound(slice);
+                long long runMiddle = bound(std::min(slice + width, threadCount));
+                long long runEnd = bound(std::min(slice + 2 * width, threadCount));
+                long long from = std::max(first, runBegin);
+                long long to = std::min(last, runEnd);
+                if (from >= to) {
+                    continue;
                 }
+                const Item* a = source + runBegin;
+                const Item* b = source + runMiddle;
+                long long aCount = runMiddle - runBegin;
+                long long bCount = runEnd - runMiddle;
+                long long aFrom = coRank(a, aCount, b, bCount, from - runBegin, byKey);
+                long long aTo = coRank(a, aCount, b, bCount, to - runBegin, byKey);
+                std::merge(a + aFrom, a + aTo, b + (from - runBegin - aFrom), b + (to - runBegin - aTo), destination + from, byKey);
             }
-            std::swap(data[i], data[minIndex]);
+            sync_point.arrive_and_wait();
+            std::swap(source, destination);
         }
+        return source;
+    }
+
+    // How many of the first `rank` outputs of a stable merge of a and b come from a (equal keys take a first)
+    template <class Item, class Less>
+    static long long coRank(const Item* a, long long aCount, const Item* b, long long bCount, long long rank, Less less) {
+        long long low = std::max(0LL, rank - bCount);
+        long long high = std::min(rank, aCount);
+        while (low < high) {
+            long long i = low + (high - low) / 2;
+            if (!less(b[rank - i - 1], a[i])) {
+                low = i + 1;
+            } else {
+                high = i;
+            }
+        }
+        return low;
     }
 };
 
+// Cooperative LSD radix sort on the key: 8-bit digits of key - min, skipping digits above the key range.
+// Every pass scatters whole records, stably, in (digit, thread) order.
+class RecordRadixSort : public RecordSortAlgorithm<RecordRadixSort> {
+    friend class RecordSortAlgorithm<RecordRadixSort>;
 
-class HeapSort : public SortingAlgorithm {
 public:
-    HeapSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : SortingAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    RecordRadixSort(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : RecordSortAlgorithm(threadCount, dataSize, verbose, reiterative) {}
 
     [[nodiscard]] std::string getType() const override {
-        return "HeapSort";
+        return "RecordRadixSort";
     }
 
 protected:
-    void sortSegment(int* data, long long start, long long end) override {
-        std::vector<int> tempData(data + start, data + end);
+    static constexpr int radixBits = 8;
+    static constexpr int radix = 1 << radixBits;
+    std::vector<long long> histograms; // histograms[t * radix + digit]
+    std::vector<int> threadMin, threadMax;
+    int passesRun = 0;
 
-        for (long long i = (end - start - 1) / 2; i >= 0; --i) {
-            heapify(tempData, tempData.size(), i);
-        }
+    std::vector<int*> generateData(long long dataSize) override {
+        histograms.assign(static_cast<size_t>(threadCount) * radix, 0);
+        threadMin.assign(threadCount, INT_MAX);
+        threadMax.assign(threadCount, INT_MIN);
+        passesRun = 0;
+        return RecordSortAlgorithm::generateData(dataSize);
+    }
 
-        for (long long i = tempData.size() - 1; i > 0; --i) {
-            std::swap(tempData[0], tempData[i]);
-            heapify(tempData, i, 0);
-        }
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        metrics["passes"] = passesRun;
+        return RecordSortAlgorithm::concat_results(partial_results, inputData, thread_count, data_size);
+    }
 
-        // printVector(tempData);
-        for (long long i = 0; i < tempData.size(); ++i) {
-            data[start + i] = tempData[i];
+    template <class Item>
+    Item* sortItems(Item* items, Item* scratch, std::barrier<>& sync_point, int thread_id) {
+        auto area = calculate_area_of_responsibility(thread_id, threadCount, dataSize);
+        const long long first = area[0];
+        const long long last = area[1];
+        int localMin = INT_MAX;
+        int localMax = INT_MIN;
+        for (long long i = first; i < last; ++i) {
+            localMin = std::min(localMin, items[i].key);
+            localMax = std::max(localMax, items[i].key);
         }
+        threadMin[thread_id] = localMin;
+        threadMax[thread_id] = localMax;
+        sync_point.arrive_and_wait();
 
-    }
+        const int low = *std::min_element(threadMin.begin(), threadMin.end());
+        const int high = *std::max_element(threadMax.begin(), threadMax.end());
+        if (low > high) {
+            return items; // nothing to sort
+        }
+        const auto range = static_cast<uint32_t>(static_cast<long long>(high) - low);
+        auto digitOf = [low](int key, int shift) {
+            return (static_cast<uint32_t>(static_cast<long long>(key) - low) >> shift) & (radix - 1);
+        };
 
-    void heapify(std::vector<int>& data, long long n, long long i) {
-        long long largest = i;
-        long long left = 2 * i + 1;
-        long long right = 2 * i + 2;
+        Item* source = items;
+        Item* destination = scratch;
+        const int bits = static_cast<int>(std::bit_width(range));
+        for (int shift = 0; shift < bits; shift += radixBits) {
+            long long* histogram = histograms.data() + static_cast<size_t>(thread_id) * radix;
+            std::fill(histogram, histogram + radix, 0);
+            for (long long i = first; i < last; ++i) {
+                ++histogram[digitOf(source[i].key, shift)];
+            }
+            sync_point.arrive_and_wait();
 
-        if (left < n && data[left] > data[largest]) {
-            largest = left;
-        }
-        if (right < n && data[right] > data[largest]) {
-            largest = right;
-        }
-        if (largest != i) {
-            std::swap(data[i], data[largest]);
-            heapify(data, n, largest);  // Continue to heapify the subtree
+            // This thread's records of digit d go after all records of smaller digits and after earlier threads' records of d
+            std::array<long long, radix> next{};
+            long long running = 0;
+            for (int digit = 0; digit < radix; ++digit) {
+                for (int t = 0; t < threadCount; ++t) {
+                    if (t == thread_id) {
+                        next[digit] = running;
+                    }
+                    running += histograms[static_cast<size_t>(t) * radix + digit];
+                }
+            }
+            for (long long i = first; i < last; ++i) {
+                destination[next[digitOf(source[i].key, shift)]++] = source[i];
+            }
+            sync_point.arrive_and_wait();
+            std::swap(source, destination);
+            if (thread_id == 0) {
+                ++passesRun;
+            }
         }
+        return source;
     }
 };
 
@@ -466,7 +4530,9 @@ public:
 protected:
     void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
         for (auto& row : data) {
-            delete[] row;
+            if (!fromDataset(row)) {
+                delete[] row;
+            }
         }
         data.clear();
         for (auto& partial_result : result) {
@@ -479,6 +4545,14 @@ protected:
 
     std::vector<int*> generateData(long long dataSize) override {
         std::vector<int*> matrix(dataSize);
+        if (!options.datasetPath.empty()) {
+            // The first dataSize * dataSize values, row-major, whatever shape the file was saved with
+            int* values = loadDataset(dataSize * dataSize);
+            for (long long i = 0; i < dataSize; ++i) {
+                matrix[i] = values + i * dataSize;
+            }
+            return matrix;
+        }
         std::random_device rd;
         std::mt19937 gen(rd());
         std::uniform_int_distribution<> dis(1, 100);
@@ -496,6 +4570,10 @@ protected:
         return {currentThread * segmentSize, (currentThread == maxThreads - 1) ? dataSize : (currentThread + 1) * segmentSize};
     }
 
+    [[nodiscard]] std::pair<long long, long long> inputShape(long long dataSize) const override {
+        return {dataSize, dataSize};
+    }
+
     std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>&  stopFlag) override {
         std::vector<int*> partialResult;
         for (long long i = area_of_responsibility[0]; i < area_of_responsibility[1]; ++i) {
@@ -504,16 +4582,29 @@ protected:
         return partialResult;
     }
 
+    // Exact check: every row is recomputed with processRow, rows spread over the pool
     bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
-        for (long long i = 0; i < dataSize; ++i) {
-            auto expected = processRow(input_data[i], input_data);
-            for (long long j = 0; j < dataSize; ++j) {
-                if (expected[j] != result[i][j]) {
-                    return false;
+        return allRowsMatch(dataSize, [&](long long i) {
+            std::unique_ptr<int[]> expected(processRow(input_data[i], input_data));
+            return std::equal(expected.get(), expected.get() + dataSize, result[i]);
+        });
+    }
+
+    // Runs rowMatches(i) for every row on the pool and stops early once a row fails
+    bool allRowsMatch(long long dataSize, const std::function<bool(long long)>& rowMatches) {
+        std::atomic<bool> mismatch = false;
+        pool().parallelFor(0, dataSize, [&](int, long long first, long long last) {
+            for (long long i = first; i < last && !mismatch.load(std::memory_order_relaxed); ++i) {
+                if (!rowMatches(i)) {
+                    mismatch = true;
+                    if (verbose) {
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        std::cerr << "Matrix result mismatch in row " << i << std::endl;
+                    }
                 }
             }
-        }
-        return true;
+        });
+        return !mismatch;
     }
 
     std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
@@ -531,58 +4622,514 @@ protected:
         return finalMatrix;
     }
 
-    virtual int* processRow(const int* row, const std::vector<int*>& matrix) = 0;
-};
+    virtual int* processRow(const int* row, const std::vector<int*>& matrix) = 0;
+};
+
+class MatrixMultiplication : public MatrixOperationAlgorithm {
+public:
+    MatrixMultiplication(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+protected:
+    int* processRow(const int* row, const std::vector<int*>& matrix) override {
+        long long size = matrix.size();
+        int* result = new int[size];
+        std::fill(result, result + size, 0);
+        for (long long col = 0; col < size; ++col) {
+            for (long long k = 0; k < size; ++k) {
+                result[col] += row[k] * matrix[k][col];
+            }
+        }
+        return result;
+    }
+
+    // Freivalds: for random 0/1 vectors x, A(Ax) must equal Cx. Each round is O(n^2) and a wrong product
+    // survives a round with probability <= 1/2. Arithmetic is mod 2^32, matching the wrap-around of int sums.
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::bernoulli_distribution coin(0.5);
+        std::vector<uint32_t> x(dataSize), ax(dataSize), aax(dataSize), cx(dataSize);
+
+        auto multiply = [&](const std::vector<int*>& matrix, const std::vector<uint32_t>& vector, std::vector<uint32_t>& product) {
+            pool().parallelFor(0, dataSize, [&](int, long long first, long long last) {
+                for (long long i = first; i < last; ++i) {
+                    uint32_t sum = 0;
+                    for (long long k = 0; k < dataSize; ++k) {
+                        sum += static_cast<uint32_t>(matrix[i][k]) * vector[k];
+                    }
+                    product[i] = sum;
+                }
+            });
+        };
+
+        for (int round = 0; round < options.freivaldsRounds; ++round) {
+            for (auto& value : x) {
+                value = coin(gen) ? 1 : 0;
+            }
+            multiply(input_data, x, ax);
+            multiply(input_data, ax, aax);
+            multiply(result, x, cx);
+            if (aax != cx) {
+                if (verbose) {
+                    std::cerr << "Freivalds check failed in round " << round << std::endl;
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+class MatrixAddition : public MatrixOperationAlgorithm {
+public:
+    MatrixAddition(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+protected:
+    int* processRow(const int* row, const std::vector<int*>& matrix) override {
+        long long size = matrix.size();
+        int* result = new int[size];
+        for (long long col = 0; col < size; ++col) {
+            result[col] = row[col] + matrix[col][col];
+        }
+        return result;
+    }
+
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        return allRowsMatch(dataSize, [&](long long i) {
+            for (long long j = 0; j < dataSize; ++j) {
+                if (result[i][j] != input_data[i][j] + input_data[j][j]) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+};
+
+class MatrixTransposition : public MatrixOperationAlgorithm {
+public:
+    MatrixTransposition(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+protected:
+    int* processRow(const int* row, const std::vector<int*>& matrix) override {
+        long long size = matrix.size();
+        int* result = new int[size];
+        long long rowIndex = std::distance(matrix.begin(), std::find(matrix.begin(), matrix.end(), row));
+        for (long long col = 0; col < size; ++col) {
+            result[col] = matrix[col][rowIndex];
+        }
+        return result;
+    }
+
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        return allRowsMatch(dataSize, [&](long long i) {
+            for (long long j = 0; j < dataSize; ++j) {
+                if (result[i][j] != input_data[j][i]) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+};
+
+// ===================== SparseMatrix =====================
+// Compressed sparse row storage. The same layout read column-wise is CSC, so toCsc() is also the transpose.
+struct SparseMatrix {
+    long long rows = 0;
+    long long cols = 0;
+    std::vector<long long> offsets; // rows + 1 entries, row i spans [offsets[i], offsets[i + 1])
+    std::vector<int> indices;       // column index of every non-zero, sorted within a row
+    std::vector<int> values;
+
+    [[nodiscard]] long long nonZeros() const {
+        return static_cast<long long>(indices.size());
+    }
+
+    [[nodiscard]] long long rowLength(long long row) const {
+        return offsets[row + 1] - offsets[row];
+    }
+
+    // Row lengths follow (rank + 1)^-powerLaw scaled to the requested density, then get shuffled across rows.
+    static SparseMatrix generateCsr(long long rows, long long cols, double density, double powerLaw, std::mt19937& gen) {
+        SparseMatrix matrix;
+        matrix.rows = rows;
+        matrix.cols = cols;
+
+        std::vector<double> weights(rows);
+        double weightSum = 0;
+        for (long long i = 0; i < rows; ++i) {
+            weights[i] = powerLaw > 0 ? std::pow(static_cast<double>(i + 1), -powerLaw) : 1.0;
+            weightSum += weights[i];
+        }
+        std::shuffle(weights.begin(), weights.end(), gen);
+
+        double targetNonZeros = std::clamp(density, 0.0, 1.0) * static_cast<double>(rows) * static_cast<double>(cols);
+        std::uniform_real_distribution<> fraction(0.0, 1.0);
+        std::vector<long long> lengths(rows);
+        for (long long i = 0; i < rows; ++i) {
+            double expected = targetNonZeros * weights[i] / weightSum;
+            auto length = static_cast<long long>(expected);
+            if (fraction(gen) < expected - static_cast<double>(length)) {
+                ++length; // randomized rounding keeps the total close to the target
+            }
+            lengths[i] = std::min(length, cols);
+        }
+
+        matrix.offsets.assign(rows + 1, 0);
+        for (long long i = 0; i < rows; ++i) {
+            matrix.offsets[i + 1] = matrix.offsets[i] + lengths[i];
+        }
+        matrix.indices.resize(matrix.offsets[rows]);
+        matrix.values.resize(matrix.offsets[rows]);
+
+        std::uniform_int_distribution<long long> columnDis(0, cols - 1);
+        std::uniform_int_distribution<> valueDis(1, 9);
+        std::vector<int> rowColumns;
+        for (long long i = 0; i < rows; ++i) {
+            long long length = lengths[i];
+            rowColumns.clear();
+            if (length * 4 >= cols) {
+                // Dense row: selection sampling visits every column once and keeps exactly `length` of them
+                long long needed = length;
+                for (long long c = 0; c < cols && needed > 0; ++c) {
+                    if (fraction(gen) * static_cast<double>(cols - c) < static_cast<double>(needed)) {
+                        rowColumns.push_back(static_cast<int>(c));
+                        --needed;
+                    }
+                }
+            } else {
+                while (static_cast<long long>(rowColumns.size()) < length) {
+                    while (static_cast<long long>(rowColumns.size()) < length) {
+                        rowColumns.push_back(static_cast<int>(columnDis(gen)));
+                    }
+                    std::sort(rowColumns.begin(), rowColumns.end());
+                    rowColumns.erase(std::unique(rowColumns.begin(), rowColumns.end()), rowColumns.end());
+                }
+            }
+            long long offset = matrix.offsets[i];
+            for (long long k = 0; k < length; ++k) {
+                matrix.indices[offset + k] = rowColumns[k];
+                matrix.values[offset + k] = valueDis(gen);
+            }
+        }
+        return matrix;
+    }
+
+    // Counting-sort transposition: column-major (CSC) storage of this matrix.
+    [[nodiscard]] SparseMatrix toCsc() const {
+        SparseMatrix csc;
+        csc.rows = rows;
+        csc.cols = cols;
+        csc.offsets.assign(cols + 1, 0);
+        for (int column : indices) {
+            ++csc.offsets[column + 1];
+        }
+        for (long long c = 0; c < cols; ++c) {
+            csc.offsets[c + 1] += csc.offsets[c];
+        }
+        csc.indices.resize(indices.size());
+        csc.values.resize(values.size());
+        std::vector<long long> next(csc.offsets.begin(), csc.offsets.end() - 1);
+        for (long long r = 0; r < rows; ++r) {
+            for (long long k = offsets[r]; k < offsets[r + 1]; ++k) {
+                long long position = next[indices[k]]++;
+                csc.indices[position] = static_cast<int>(r);
+                csc.values[position] = values[k];
+            }
+        }
+        return csc;
+    }
+};
+
+// ===================== SparseMatrixAlgorithm =====================
+class SparseMatrixAlgorithm : public Algorithm {
+public:
+    SparseMatrixAlgorithm(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : Algorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SparseMatrixAlgorithm";
+    }
+
+protected:
+    SparseMatrix a;
+    std::vector<long long> workPrefix; // workPrefix[i] = estimated cost of rows [0, i)
+
+    // Estimated cost of one row, used to balance the row partition
+    virtual long long rowWork(long long row) const = 0;
+    virtual std::vector<int*> generateOperands(long long dataSize, std::mt19937& gen) = 0;
+
+    std::vector<int*> generateData(long long dataSize) override {
+        if (dataSize > INT_MAX) {
+            throw std::invalid_argument("Sparse matrix dimension must fit in an int column index.");
+        }
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        a = SparseMatrix::generateCsr(dataSize, dataSize, options.sparseDensity, options.sparsePowerLaw, gen);
+        auto operands = generateOperands(dataSize, gen);
+
+        workPrefix.assign(dataSize + 1, 0);
+        long long maxRow = 0;
+        for (long long i = 0; i < dataSize; ++i) {
+            workPrefix[i + 1] = workPrefix[i] + rowWork(i);
+            maxRow = std::max(maxRow, a.rowLength(i));
+        }
+
+        metrics["nnz"] = a.nonZeros();
+        metrics["density"] = static_cast<double>(a.nonZeros()) / (static_cast<double>(dataSize) * static_cast<double>(dataSize));
+        metrics["max_row_nnz"] = maxRow;
+        if (verbose) {
+            std::cout << "Generated " << dataSize << "x" << dataSize << " CSR matrix with " << a.nonZeros() << " non-zeros." << std::endl;
+        }
+        return operands;
+    }
+
+    // Rows are split so every thread gets the same share of work rather than the same number of rows.
+    std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) override {
+        auto rowAt = [&](int thread) -> long long {
+            if (thread >= maxThreads) {
+                return dataSize;
+            }
+            long long target = workPrefix[dataSize] / maxThreads * thread + workPrefix[dataSize] % maxThreads * thread / maxThreads;
+            return std::lower_bound(workPrefix.begin(), workPrefix.end(), target) - workPrefix.begin();
+        };
+        return {rowAt(currentThread), rowAt(currentThread + 1)};
+    }
+
+    void recordWorkImbalance(int thread_count, long long data_size) {
+        long long maxWork = 0;
+        for (int i = 0; i < thread_count; ++i) {
+            auto area = calculate_area_of_responsibility(i, thread_count, data_size);
+            maxWork = std::max(maxWork, workPrefix[area[1]] - workPrefix[area[0]]);
+        }
+        double averageWork = static_cast<double>(workPrefix[data_size]) / thread_count;
+        metrics["work_imbalance"] = averageWork > 0 ? static_cast<double>(maxWork) / averageWork : 1.0;
+    }
+};
+
+class SparseMatrixVectorMultiplication : public SparseMatrixAlgorithm {
+public:
+    SparseMatrixVectorMultiplication(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SparseMatrixAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SparseMatrixVectorMultiplication";
+    }
+
+protected:
+    long long rowWork(long long row) const override {
+        return a.rowLength(row) + 1;
+    }
+
+    // data = {x, y}: the dense input vector and the output vector the threads write into
+    std::vector<int*> generateOperands(long long dataSize, std::mt19937& gen) override {
+        auto* x = new int[dataSize];
+        auto* y = new int[dataSize];
+        std::uniform_int_distribution<> dis(1, 100);
+        for (long long i = 0; i < dataSize; ++i) {
+            x[i] = dis(gen);
+        }
+        std::fill(y, y + dataSize, 0);
+        return {x, y};
+    }
+
+    std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>& stopFlag) override {
+        const int* x = inputData[0];
+        int* y = inputData[1];
+        const long long* offsets = a.offsets.data();
+        const int* indices = a.indices.data();
+        const int* values = a.values.data();
+        for (long long row = area_of_responsibility[0]; row < area_of_responsibility[1]; ++row) {
+            long long sum = 0;
+            for (long long k = offsets[row]; k < offsets[row + 1]; ++k) {
+                sum += static_cast<long long>(values[k]) * x[indices[k]];
+            }
+            y[row] = static_cast<int>(sum);
+        }
+        return {};
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>&, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        recordWorkImbalance(thread_count, data_size);
+        return {inputData[1]}; // every thread wrote its own rows of y in place
+    }
+
+    // Reference product computed column by column from the CSC form, independent of the row kernel
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        SparseMatrix csc = a.toCsc();
+        std::vector<long long> expected(dataSize, 0);
+        for (long long column = 0; column < dataSize; ++column) {
+            for (long long k = csc.offsets[column]; k < csc.offsets[column + 1]; ++k) {
+                expected[csc.indices[k]] += static_cast<long long>(csc.values[k]) * input_data[0][column];
+            }
+        }
+        for (long long i = 0; i < dataSize; ++i) {
+            if (static_cast<int>(expected[i]) != result[0][i]) {
+                if (verbose) {
+                    std::cerr << "SpMV mismatch at row " << i << std::endl;
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
+        for (auto& vector : data) {
+            delete[] vector;
+        }
+        data.clear();
+        result.clear();
+    }
+};
+
+class SparseMatrixMultiplication : public SparseMatrixAlgorithm {
+public:
+    SparseMatrixMultiplication(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
+        : SparseMatrixAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "SparseMatrixMultiplication";
+    }
+
+protected:
+    SparseMatrix b;
+    SparseMatrix c;
+
+    // Gustavson row-by-row product: the cost of row i is the number of multiply-adds it performs
+    long long rowWork(long long row) const override {
+        long long work = 1;
+        for (long long k = a.offsets[row]; k < a.offsets[row + 1]; ++k) {
+            work += b.rowLength(a.indices[k]);
+        }
+        return work;
+    }
+
+    std::vector<int*> generateOperands(long long dataSize, std::mt19937& gen) override {
+        b = SparseMatrix::generateCsr(dataSize, dataSize, options.sparseDensity, options.sparsePowerLaw, gen);
+        return {};
+    }
+
+    // Each thread returns {row lengths, column indices, values} for its rows, using a sparse accumulator
+    // (dense value array plus a list of touched columns) that is reused across rows.
+    std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>&, std::atomic<bool>& stopFlag) override {
+        long long first = area_of_responsibility[0];
+        long long last = area_of_responsibility[1];
+        long long capacity = workPrefix[last] - workPrefix[first] - (last - first); // multiply-adds bound the output size
 
-class MatrixMultiplication : public MatrixOperationAlgorithm {
-public:
-    MatrixMultiplication(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+        auto* rowLengths = new int[last - first];
+        auto* columns = new int[std::max(capacity, 1LL)];
+        auto* values = new int[std::max(capacity, 1LL)];
 
-protected:
-    int* processRow(const int* row, const std::vector<int*>& matrix) override {
-        long long size = matrix.size();
-        int* result = new int[size];
-        std::fill(result, result + size, 0);
-        for (long long col = 0; col < size; ++col) {
-            for (long long k = 0; k < size; ++k) {
-                result[col] += row[k] * matrix[k][col];
+        std::vector<long long> accumulator(b.cols, 0);
+        std::vector<char> occupied(b.cols, 0);
+        std::vector<int> touched;
+        long long written = 0;
+        for (long long row = first; row < last; ++row) {
+            touched.clear();
+            for (long long k = a.offsets[row]; k < a.offsets[row + 1]; ++k) {
+                long long scale = a.values[k];
+                int bRow = a.indices[k];
+                for (long long m = b.offsets[bRow]; m < b.offsets[bRow + 1]; ++m) {
+                    int column = b.indices[m];
+                    if (!occupied[column]) {
+                        occupied[column] = 1;
+                        touched.push_back(column);
+                    }
+                    accumulator[column] += scale * b.values[m];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            for (int column : touched) {
+                columns[written] = column;
+                values[written] = static_cast<int>(accumulator[column]);
+                ++written;
+                accumulator[column] = 0;
+                occupied[column] = 0;
             }
+            rowLengths[row - first] = static_cast<int>(touched.size());
         }
-        return result;
+        return {rowLengths, columns, values};
     }
-};
 
-class MatrixAddition : public MatrixOperationAlgorithm {
-public:
-    MatrixAddition(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    // Stitches the per-thread row blocks into one CSR matrix; the copies run in parallel, one per block.
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>&, int thread_count, long long data_size) override {
+        c = SparseMatrix();
+        c.rows = data_size;
+        c.cols = data_size;
+        c.offsets.assign(data_size + 1, 0);
 
-protected:
-    int* processRow(const int* row, const std::vector<int*>& matrix) override {
-        long long size = matrix.size();
-        int* result = new int[size];
-        for (long long col = 0; col < size; ++col) {
-            result[col] = row[col] + matrix[col][col];
+        std::vector<std::vector<long long>> areas(thread_count);
+        for (int i = 0; i < thread_count; ++i) {
+            areas[i] = calculate_area_of_responsibility(i, thread_count, data_size);
+            for (long long row = areas[i][0]; row < areas[i][1]; ++row) {
+                c.offsets[row + 1] = c.offsets[row] + partial_results[i][0][row - areas[i][0]];
+            }
         }
-        return result;
+        c.indices.resize(c.offsets[data_size]);
+        c.values.resize(c.offsets[data_size]);
+
+        std::vector<std::thread> copies;
+        for (int i = 0; i < thread_count; ++i) {
+            copies.emplace_back([&, i]() {
+                long long destination = c.offsets[areas[i][0]];
+                long long count = c.offsets[areas[i][1]] - destination;
+                std::copy(partial_results[i][1], partial_results[i][1] + count, c.indices.begin() + destination);
+                std::copy(partial_results[i][2], partial_results[i][2] + count, c.values.begin() + destination);
+            });
+        }
+        for (auto& t : copies) {
+            t.join();
+        }
+
+        recordWorkImbalance(thread_count, data_size);
+        metrics["flops"] = workPrefix[data_size] - data_size;
+        metrics["output_nnz"] = c.nonZeros();
+        return {}; // the product lives in `c`
     }
-};
 
-class MatrixTransposition : public MatrixOperationAlgorithm {
-public:
-    MatrixTransposition(int threadCount, long long dataSize, bool verbose = false, bool* reiterative = nullptr)
-        : MatrixOperationAlgorithm(threadCount, dataSize, verbose, reiterative) {}
+    // Reference product with a hash accumulator, compared row by row against the SPA kernel's output
+    bool test_result(const std::vector<int*>&, const std::vector<int*>&, long long dataSize) override {
+        std::unordered_map<int, long long> accumulator;
+        std::vector<std::pair<int, long long>> expected;
+        for (long long row = 0; row < dataSize; ++row) {
+            accumulator.clear();
+            for (long long k = a.offsets[row]; k < a.offsets[row + 1]; ++k) {
+                int bRow = a.indices[k];
+                for (long long m = b.offsets[bRow]; m < b.offsets[bRow + 1]; ++m) {
+                    accumulator[b.indices[m]] += static_cast<long long>(a.values[k]) * b.values[m];
+                }
+            }
+            expected.assign(accumulator.begin(), accumulator.end());
+            std::sort(expected.begin(), expected.end());
+            if (static_cast<long long>(expected.size()) != c.rowLength(row)) {
+                return false;
+            }
+            for (size_t k = 0; k < expected.size(); ++k) {
+                long long position = c.offsets[row] + static_cast<long long>(k);
+                if (c.indices[position] != expected[k].first || c.values[position] != static_cast<int>(expected[k].second)) {
+                    if (verbose) {
+                        std::cerr << "SpGEMM mismatch in row " << row << std::endl;
+                    }
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
 
-protected:
-    int* processRow(const int* row, const std::vector<int*>& matrix) override {
-        long long size = matrix.size();
-        int* result = new int[size];
-        long long rowIndex = std::distance(matrix.begin(), std::find(matrix.begin(), matrix.end(), row));
-        for (long long col = 0; col < size; ++col) {
-            result[col] = matrix[col][rowIndex];
+    void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
+        data.clear();
+        for (auto& partial_result : result) {
+            for (auto& block : partial_result) {
+                delete[] block;
+            }
         }
-        return result;
+        result.clear();
     }
 };
 
@@ -600,9 +5147,14 @@ public:
 
 protected:
     std::vector<int*> generateData(long long dataSize) override {
-        auto* data = new int[dataSize];
-        for (long long i = 0; i < dataSize; ++i) {
-            data[i] = i + 1;
+        int* data;
+        if (!options.datasetPath.empty()) {
+            data = loadDataset(dataSize);
+        } else {
+            data = new int[dataSize];
+            for (long long i = 0; i < dataSize; ++i) {
+                data[i] = i + 1;
+            }
         }
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -621,6 +5173,10 @@ protected:
         return {currentThread * segmentSize, (currentThread == maxThreads - 1) ? dataSize : (currentThread + 1) * segmentSize};
     }
 
+    [[nodiscard]] std::pair<long long, long long> inputShape(long long dataSize) const override {
+        return {1, dataSize};
+    }
+
     std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>& stopFlag) override {
         for (long long i = area_of_responsibility[0]; i < area_of_responsibility[1] && !stopFlag; ++i) {
             if (inputData[0][i] == targetNumber) {
@@ -653,7 +5209,9 @@ protected:
 
     void cleanupData(std::vector<int*>& data, std::vector<std::vector<int*>>& result) const override {
         if (!data.empty() && data[0] != nullptr) {
-            delete[] data[0];
+            if (!fromDataset(data[0])) {
+                delete[] data[0];
+            }
             data[0] = nullptr;
         }
         data.clear();
@@ -678,24 +5236,55 @@ public:
     }
 
 protected:
+    // Keys scanned between reads of the shared stop flag (16 KB, 256 cache lines)
+    static constexpr long long pollChunk = 4096;
+
+    std::atomic<long long> bytesScanned = 0;
+    std::atomic<long long> slowestScanNs = 0;
+
     std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>& stopFlag) override {
-        for (long long i = area_of_responsibility[0]; i < area_of_responsibility[1] && !stopFlag; ++i) {
-            if (inputData[0][i] == targetNumber) {
-                found = true;
-                foundIndex = i;
-                stopFlag = true;
-                if (verbose) {
-                    std::lock_guard<std::mutex> lock(outputMutex);
-                    std::cout << "Thread found the number " << targetNumber << " at index " << i << std::endl;
-                }
-                break;
+        auto begin = std::chrono::steady_clock::now();
+        SimdLevel level = std::min(options.simdLevel, detectSimdLevel());
+        long long scanned = 0;
+        for (long long i = area_of_responsibility[0]; i < area_of_responsibility[1] && !stopFlag.load(std::memory_order_relaxed); i += pollChunk) {
+            long long count = std::min(pollChunk, area_of_responsibility[1] - i);
+            long long hit = findKey(inputData[0] + i, count, targetNumber, level);
+            if (hit < 0) {
+                scanned += count;
+                continue;
+            }
+            scanned += hit + 1;
+            found = true;
+            foundIndex = i + hit;
+            stopFlag = true;
+            if (verbose) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cout << "Thread found the number " << targetNumber << " at index " << i + hit << std::endl;
             }
+            break;
+        }
+        bytesScanned += scanned * static_cast<long long>(sizeof(int));
+        long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        long long slowest = slowestScanNs.load();
+        while (elapsed > slowest && !slowestScanNs.compare_exchange_weak(slowest, elapsed)) {
         }
         return {};
     }
+
+    // Bandwidth is the bytes all threads compared over the time of the slowest thread
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        double seconds = static_cast<double>(slowestScanNs.load()) * 1e-9;
+        metrics["simd"] = simdLevelName(std::min(options.simdLevel, detectSimdLevel()));
+        metrics["scan_bytes"] = bytesScanned.load();
+        metrics["scan_seconds"] = seconds;
+        metrics["scan_gb_per_s"] = seconds > 0 ? static_cast<double>(bytesScanned.load()) / seconds * 1e-9 : 0.0;
+        return SearchAlgorithms::concat_results(partial_results, inputData, thread_count, data_size);
+    }
 };
 
 
+// Without --queries, one target searched by slices of the array. With --queries=Q, Q lookups of keys drawn from the
+// array are spread over the threads; each is a branchless lower bound, so every probe is a data dependency only.
 class BinarySearch : public SearchAlgorithms {
 public:
     BinarySearch(int threadCount, long long dataSize, bool verbose = false)
@@ -706,7 +5295,31 @@ public:
     }
 
 protected:
+    static constexpr int interleaveGroup = 16;          // lookups in flight per thread in interleaved mode
+    static constexpr long long latencySampleEvery = 16; // every 16th query is timed on its own
+
+    long long queryCount = 0;
+    std::unique_ptr<int[]> queries;
+    std::unique_ptr<long long[]> positions;   // lower bound of each query
+    std::vector<long long> latencySamples;    // nanoseconds
+    std::mutex latencyMutex;
+    std::atomic<long long> slowestQueryNs = 0;
+
     std::vector<int*> execute(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData, std::atomic<bool>& stopFlag) override {
+        if (queryCount > 0) {
+            auto begin = std::chrono::steady_clock::now();
+            std::vector<long long> samples;
+            samples.reserve((area_of_responsibility[1] - area_of_responsibility[0]) / latencySampleEvery + 1);
+            lookupRange(inputData[0], area_of_responsibility[0], area_of_responsibility[1], samples);
+            long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            long long slowest = slowestQueryNs.load();
+            while (elapsed > slowest && !slowestQueryNs.compare_exchange_weak(slowest, elapsed)) {
+            }
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latencySamples.insert(latencySamples.end(), samples.begin(), samples.end());
+            return {};
+        }
+
         long long start = area_of_responsibility[0];
         long long end = area_of_responsibility[1];
         while (start < end && !stopFlag) {
@@ -729,10 +5342,532 @@ protected:
         return {};
     }
 
+    // Fills positions[begin, end) and appends the latency of the sampled queries among them
+    virtual void lookupRange(const int* sorted, long long begin, long long end, std::vector<long long>& samples) {
+        switch (options.lookupMode) {
+            case LookupMode::Plain: lookupEach<false>(sorted, begin, end, samples); break;
+            case LookupMode::Prefetch: lookupEach<true>(sorted, begin, end, samples); break;
+            case LookupMode::Interleaved: lookupInterleaved(sorted, begin, end, samples); break;
+        }
+    }
+
+    // Index of the first of the count sorted keys that is not below key; count must be positive
+    template <bool Prefetch>
+    static long long lowerBound(const int* sorted, long long count, int key) {
+        const int* base = sorted;
+        long long remaining = count;
+        while (remaining > 1) {
+            long long half = remaining / 2;
+            if constexpr (Prefetch) {
+                // the next probe is one of these two, whichever way this comparison goes
+                __builtin_prefetch(base + (remaining - half) / 2);
+                __builtin_prefetch(base + half + (remaining - half) / 2);
+            }
+            base = base[half] < key ? base + half : base;
+            remaining -= half;
+        }
+        return (base - sorted) + (*base < key);
+    }
+
+    template <bool Prefetch>
+    void lookupEach(const int* sorted, long long begin, long long end, std::vector<long long>& samples) {
+        lookupEach(begin, end, samples, [&](int key) { return lowerBound<Prefetch>(sorted, dataSize, key); });
+    }
+
+    // positions[q] = lookup(queries[q]) for each q in [begin, end), one query at a time
+    template <class Lookup>
+    void lookupEach(long long begin, long long end, std::vector<long long>& samples, Lookup&& lookup) {
+        for (long long q = begin; q < end; ++q) {
+            if (q % latencySampleEvery != 0) {
+                positions[q] = lookup(queries[q]);
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            positions[q] = lookup(queries[q]);
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    // AMAC: interleaveGroup lookups each take one probe per round and prefetch their next one, so a lookup's miss is
+    // served while the others probe. A finished lookup's slot is refilled with the next query at once. Latency is
+    // counted from a query entering the group to its result.
+    void lookupInterleaved(const int* sorted, long long begin, long long end, std::vector<long long>& samples) {
+        struct Lookup {
+            const int* base;
+            long long remaining;
+            long long query;
+            int key;
+            std::chrono::steady_clock::time_point start;
+        };
+        std::array<Lookup, interleaveGroup> group;
+        int active = 0;
+        long long next = begin;
+        auto admit = [&](Lookup& lookup) {
+            lookup = {sorted, dataSize, next, queries[next], {}};
+            if (next % latencySampleEvery == 0) {
+                lookup.start = std::chrono::steady_clock::now();
+            }
+            __builtin_prefetch(sorted + dataSize / 2);
+            ++next;
+        };
+        while (active < interleaveGroup && next < end) {
+            admit(group[active++]);
+        }
+        while (active > 0) {
+            for (int slot = 0; slot < active;) {
+                Lookup& lookup = group[slot];
+                if (lookup.remaining > 1) {
+                    long long half = lookup.remaining / 2;
+                    lookup.base = lookup.base[half] < lookup.key ? lookup.base + half : lookup.base;
+                    lookup.remaining -= half;
+                    __builtin_prefetch(lookup.base + lookup.remaining / 2);
+                    ++slot;
+                    continue;
+                }
+                positions[lookup.query] = (lookup.base - sorted) + (*lookup.base < lookup.key);
+                if (lookup.query % latencySampleEvery == 0) {
+                    samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - lookup.start).count());
+                }
+                if (next < end) {
+                    admit(lookup);
+                } else {
+                    lookup = group[--active]; // the slot now holds a lookup that has not had this round's probe
+                }
+            }
+        }
+    }
+
     std::vector<int*> generateData(long long dataSize) override {
         auto data = SearchAlgorithms::generateData(dataSize);
         std::sort(data[0], data[0] + dataSize); // Ensure data is sorted for binary search
+        queryCount = requestedQueries();
+        if (queryCount > 0) {
+            queries = std::make_unique<int[]>(queryCount);
+            positions = std::make_unique<long long[]>(queryCount);
+            std::mt19937_64 gen(std::random_device{}());
+            std::uniform_int_distribution<long long> index(0, dataSize - 1);
+            for (long long q = 0; q < queryCount; ++q) {
+                queries[q] = data[0][index(gen)];
+            }
+        }
+        return data;
+    }
+
+    // Lookups in batch mode; 0 searches a single target
+    [[nodiscard]] virtual long long requestedQueries() const {
+        return options.queryCount;
+    }
+
+    std::vector<long long> calculate_area_of_responsibility(int currentThread, int maxThreads, long long dataSize) override {
+        return SearchAlgorithms::calculate_area_of_responsibility(currentThread, maxThreads, queryCount > 0 ? queryCount : dataSize);
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        if (queryCount > 0) {
+            double seconds = static_cast<double>(slowestQueryNs.load()) * 1e-9;
+            metrics["queries"] = queryCount;
+            metrics["lookup"] = lookupModeName(options.lookupMode);
+            metrics["query_seconds"] = seconds;
+            metrics["queries_per_second"] = seconds > 0 ? static_cast<double>(queryCount) / seconds : 0.0;
+            std::sort(latencySamples.begin(), latencySamples.end());
+            auto percentile = [&](double p) {
+                auto rank = static_cast<size_t>(p * static_cast<double>(latencySamples.size()));
+                return latencySamples.empty() ? 0LL : latencySamples[std::min(rank, latencySamples.size() - 1)];
+            };
+            metrics["latency_ns"] = {{"p50", percentile(0.5)}, {"p90", percentile(0.9)}, {"p99", percentile(0.99)},
+                                     {"p999", percentile(0.999)}, {"samples", latencySamples.size()}};
+        }
+        return SearchAlgorithms::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    // Batch mode: every position is the std::lower_bound of its query, checked on the pool
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>& result, long long dataSize) override {
+        if (queryCount == 0) {
+            return SearchAlgorithms::test_result(input_data, result, dataSize);
+        }
+        std::atomic<long long> wrong = -1;
+        const int* sorted = input_data[0];
+        pool().parallelFor(0, queryCount, [&](int, long long first, long long last) {
+            for (long long q = first; q < last; ++q) {
+                if (positions[q] != std::lower_bound(sorted, sorted + dataSize, queries[q]) - sorted) {
+                    wrong = q;
+                    return;
+                }
+            }
+        });
+        if (wrong >= 0 && verbose) {
+            std::cerr << "Query " << wrong << " for " << queries[wrong] << " returned position " << positions[wrong] << std::endl;
+        }
+        return wrong < 0;
+    }
+};
+
+
+// ===================== Search layouts =====================
+// Batched lookups (--queries, default one per element) on a copy of the sorted keys rearranged for the cache.
+// The threads build the layout together, meet at the barrier, then answer their queries; build and query time are
+// reported separately, together with the break-even query count against binary search on the sorted array.
+class SearchLayout : public BinarySearch {
+public:
+    SearchLayout(int threadCount, long long dataSize, bool verbose = false)
+        : BinarySearch(threadCount, dataSize, verbose) {}
+
+protected:
+    std::unique_ptr<int[]> layoutStorage;
+    int* layout = nullptr;            // 64-byte aligned view into layoutStorage
+    long long layoutSize = 0;         // ints
+    long long buildNs = 0;
+    double sortedSecondsPerQuery = 0; // binary search on the sorted array, measured while preparing the input
+
+    // Ints the layout of dataSize keys takes; allocated untimed, filled by buildPart
+    [[nodiscard]] virtual long long layoutInts() const = 0;
+    // Fills this thread's share of the layout from the sorted keys
+    virtual void buildPart(const int* sorted, int thread_id, int threads) = 0;
+    [[nodiscard]] virtual const char* layoutName() const = 0;
+
+    // positions hold layout indices (-1: every key is below the query), so results are checked by the key they point at
+    [[nodiscard]] int keyAt(long long position) const {
+        return layout[position];
+    }
+
+    [[nodiscard]] long long requestedQueries() const override {
+        return options.queryCount > 0 ? options.queryCount : dataSize;
+    }
+
+    std::vector<int*> generateData(long long dataSize) override {
+        auto data = BinarySearch::generateData(dataSize);
+        layoutSize = layoutInts();
+        layoutStorage.reset(new int[layoutSize + 16]); // slack to align the start to a cache line
+        auto address = reinterpret_cast<uintptr_t>(layoutStorage.get());
+        layout = layoutStorage.get() + (64 - address % 64) % 64 / sizeof(int);
+        // Baseline for the break-even point: prefetching binary search over up to 2^20 of the queries, on all threads
+        long long sample = std::min(queryCount, 1LL << 20);
+        const int* sorted = data[0];
+        auto start = std::chrono::steady_clock::now();
+        pool().parallelFor(0, sample, [&](int, long long first, long long last) {
+            for (long long q = first; q < last; ++q) {
+                positions[q] = lowerBound<true>(sorted, dataSize, queries[q]);
+            }
+        });
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        sortedSecondsPerQuery = sample > 0 ? elapsed.count() / static_cast<double>(sample) : 0.0;
         return data;
     }
+
+    std::vector<int*> executeCooperative(const std::vector<long long>& area_of_responsibility, const std::vector<int*>& inputData,
+        std::atomic<bool>& stopFlag, std::barrier<>& sync_point, int thread_id) override {
+        auto begin = std::chrono::steady_clock::now();
+        buildPart(inputData[0], thread_id, threadCount);
+        sync_point.arrive_and_wait();
+        if (thread_id == 0) {
+            buildNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        }
+        return execute(area_of_responsibility, inputData, stopFlag);
+    }
+
+    std::vector<int*> concat_results(const std::vector<std::vector<int*>>& partial_results, const std::vector<int*>& inputData, int thread_count, long long data_size) override {
+        double buildSeconds = static_cast<double>(buildNs) * 1e-9;
+        double secondsPerQuery = static_cast<double>(slowestQueryNs.load()) * 1e-9 / static_cast<double>(queryCount);
+        metrics["layout"] = layoutName();
+        metrics["layout_bytes"] = layoutSize * static_cast<long long>(sizeof(int));
+        metrics["build_seconds"] = buildSeconds;
+        metrics["seconds_per_query"] = secondsPerQuery;
+        metrics["sorted_array_seconds_per_query"] = sortedSecondsPerQuery;
+        // Queries after which building the layout has paid for itself; null if its lookups are not faster
+        metrics["break_even_queries"] = secondsPerQuery < sortedSecondsPerQuery
+            ? nlohmann::json(static_cast<long long>(std::ceil(buildSeconds / (sortedSecondsPerQuery - secondsPerQuery))))
+            : nlohmann::json(nullptr);
+        return BinarySearch::concat_results(partial_results, inputData, thread_count, data_size);
+    }
+
+    bool test_result(const std::vector<int*>& input_data, const std::vector<int*>&, long long dataSize) override {
+        std::atomic<long long> wrong = -1;
+        const int* sorted = input_data[0];
+        pool().parallelFor(0, queryCount, [&](int, long long first, long long last) {
+            for (long long q = first; q < last; ++q) {
+                long long expected = std::lower_bound(sorted, sorted + dataSize, queries[q]) - sorted;
+                bool correct = expected == dataSize ? positions[q] == -1
+                                                    : positions[q] >= 0 && positions[q] < layoutSize && keyAt(positions[q]) == sorted[expected];
+                if (!correct) {
+                    wrong = q;
+                    return;
+                }
+            }
+        });
+        if (wrong >= 0 && verbose) {
+            std::cerr << "Query " << wrong << " for " << queries[wrong] << " returned layout position " << positions[wrong] << std::endl;
+        }
+        return wrong < 0;
+    }
+};
+
+// Eytzinger (BFS) order: node k's children are 2k and 2k + 1, so the 16 descendants four levels down share a cache
+// line and one prefetch per step keeps four levels of the descent in flight. Node 0 is unused.
+class EytzingerSearch : public SearchLayout {
+public:
+    EytzingerSearch(int threadCount, long long dataSize, bool verbose = false)
+        : SearchLayout(threadCount, dataSize, verbose) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "EytzingerSearch";
+    }
+
+protected:
+    [[nodiscard]] const char* layoutName() const override {
+        return "eytzinger";
+    }
+
+    [[nodiscard]] long long layoutInts() const override {
+        return dataSize + 1;
+    }
+
+    // Nodes in the subtree rooted at k
+    [[nodiscard]] long long subtreeSize(long long k) const {
+        long long count = 0;
+        for (long long first = k, last = k; first <= dataSize; first = 2 * first, last = 2 * last + 1) {
+            count += std::min(last, dataSize) - first + 1;
+        }
+        return count;
+    }
+
+    // Sorted index of the smallest key in the subtree rooted at k: the bits of k below its leading one are the path
+    [[nodiscard]] long long subtreeOffset(long long k) const {
+        long long offset = 0;
+        long long node = 1;
+        for (int level = std::bit_width(static_cast<unsigned long long>(k)) - 2; level >= 0; --level) {
+            long long right = (k >> level) & 1;
+            if (right != 0) {
+                offset += subtreeSize(2 * node) + 1;
+            }
+            node = 2 * node + right;
+        }
+        return offset;
+    }
+
+    void fill(const int* sorted, long long k, long long offset) {
+        if (k > dataSize) {
+            return;
+        }
+        long long left = subtreeSize(2 * k);
+        fill(sorted, 2 * k, offset);
+        layout[k] = sorted[offset + left];
+        fill(sorted, 2 * k + 1, offset + left + 1);
+    }
+
+    // Thread 0 fills the levels above splitDepth; the subtrees rooted there are dealt out round-robin
+    void buildPart(const int* sorted, int thread_id, int threads) override {
+        int splitDepth = std::min<int>(std::bit_width(4ULL * static_cast<unsigned>(threads)),
+                                       std::bit_width(static_cast<unsigned long long>(dataSize)) - 1);
+        long long splitBegin = 1LL << splitDepth;
+        if (thread_id == 0) {
+            for (long long k = 1; k < splitBegin; ++k) {
+                layout[k] = sorted[subtreeOffset(k) + subtreeSize(2 * k)];
+            }
+        }
+        for (long long k = splitBegin + thread_id; k < std::min(2 * splitBegin, dataSize + 1); k += threads) {
+            fill(sorted, k, subtreeOffset(k));
+        }
+    }
+
+    void lookupRange(const int* sorted, long long begin, long long end, std::vector<long long>& samples) override {
+        if (options.lookupMode == LookupMode::Plain) {
+            lookupEach(begin, end, samples, [this](int key) { return descend<false>(key); });
+        } else {
+            lookupEach(begin, end, samples, [this](int key) { return descend<true>(key); });
+        }
+    }
+
+    // Layout index of the first key not below key, or -1. The loop always runs to a leaf; the answer is the node where
+    // the path last went left, recovered from the trailing ones of k.
+    template <bool Prefetch>
+    long long descend(int key) const {
+        long long k = 1;
+        while (k <= dataSize) {
+            if constexpr (Prefetch) {
+                __builtin_prefetch(layout + 16 * k);
+            }
+            k = 2 * k + (layout[k] < key);
+        }
+        k >>= std::countr_one(static_cast<unsigned long long>(k)) + 1;
+        return k == 0 ? -1 : k;
+    }
 };
 
+
+// Static B-tree with 16 keys per node, one cache line: node k holds keys [16k, 16k + 16) of the layout and its 17
+// children are nodes 17k + 1 .. 17k + 17. Keys are in order within a node and the tail is padded with INT_MAX.
+// A lookup touches one line per level, log17 of the size instead of log2.
+class STreeSearch : public SearchLayout {
+public:
+    STreeSearch(int threadCount, long long dataSize, bool verbose = false)
+        : SearchLayout(threadCount, dataSize, verbose) {}
+
+    [[nodiscard]] std::string getType() const override {
+        return "STreeSearch";
+    }
+
+protected:
+    static constexpr long long nodeKeys = 16;
+    static constexpr long long fanout = nodeKeys + 1;
+    static constexpr int lookupGroup = 16; // lookups walked level by level together in prefetch and interleaved modes
+
+    struct ScalarRank {
+        static int rank(const int* node, int key) {
+            int below = 0;
+            for (int i = 0; i < nodeKeys; ++i) {
+                below += node[i] < key;
+            }
+            return below;
+        }
+    };
+
+    [[nodiscard]] const char* layoutName() const override {
+        return "s_tree";
+    }
+
+    [[nodiscard]] long long nodeCount() const {
+        return (dataSize + nodeKeys - 1) / nodeKeys;
+    }
+
+    [[nodiscard]] long long layoutInts() const override {
+        return nodeCount() * nodeKeys;
+    }
+
+    static long long child(long long k, long long i) {
+        return k * fanout + i + 1;
+    }
+
+    // Keys in the subtree rooted at k (a whole number of nodes)
+    [[nodiscard]] long long subtreeKeys(long long k) const {
+        long long nodes = nodeCount();
+        long long count = 0;
+        for (long long first = k, last = k; first < nodes; first = child(first, 0), last = child(last, nodeKeys)) {
+            count += std::min(last, nodes - 1) - first + 1;
+        }
+        return count * nodeKeys;
+    }
+
+    // In-order index of the smallest key in the subtree rooted at k: every left sibling's subtree and the keys
+    // between them come first, at every level of the path from the root
+    [[nodiscard]] long long subtreeOffset(long long k) const {
+        std::vector<long long> path;
+        for (; k > 0; k = (k - 1) / fanout) {
+            path.push_back((k - 1) % fanout);
+        }
+        long long offset = 0;
+        long long node = 0;
+        for (auto step = path.rbegin(); step != path.rend(); ++step) {
+            for (long long i = 0; i < *step; ++i) {
+                offset += subtreeKeys(child(node, i));
+            }
+            offset += *step;
+            node = child(node, *step);
+        }
+        return offset;
+    }
+
+    // Writes node k's keys given the in-order index of its subtree's first key; with recurse, its subtrees' too
+    void fill(const int* sorted, long long k, long long offset, bool recurse) {
+        if (k >= nodeCount()) {
+            return;
+        }
+        for (long long i = 0; i <= nodeKeys; ++i) {
+            long long below = child(k, i);
+            if (recurse) {
+                fill(sorted, below, offset, true);
+            }
+            offset += subtreeKeys(below);
+            if (i < nodeKeys) {
+                layout[k * nodeKeys + i] = offset < dataSize ? sorted[offset] : INT_MAX;
+                ++offset;
+            }
+        }
+    }
+
+    // Thread 0 fills the levels above the first one with at least 4 nodes per thread (or the last level); the
+    // subtrees rooted on that level are dealt out round-robin
+    void buildPart(const int* sorted, int thread_id, int threads) override {
+        long long nodes = nodeCount();
+        long long levelBegin = 0;
+        long long levelWidth = 1;
+        while (levelWidth < 4LL * threads && child(levelBegin, 0) < nodes) {
+            levelBegin = child(levelBegin, 0);
+            levelWidth *= fanout;
+        }
+        if (thread_id == 0) {
+            for (long long k = 0; k < levelBegin; ++k) {
+                fill(sorted, k, subtreeOffset(k), false);
+            }
+        }
+        for (long long k = levelBegin + thread_id; k < std::min(levelBegin + levelWidth, nodes); k += threads) {
+            fill(sorted, k, subtreeOffset(k), true);
+        }
+    }
+
+    void lookupRange(const int* sorted, long long begin, long long end, std::vector<long long>& samples) override {
+#ifdef BITONIC_NETWORK_X86
+        if (std::min(options.simdLevel, detectSimdLevel()) != SimdLevel::Scalar) {
+            lookupWith<NodeRankAvx2>(begin, end, samples);
+            return;
+        }
+#endif
+        lookupWith<ScalarRank>(begin, end, samples);
+    }
+
+    template <class Rank>
+    void lookupWith(long long begin, long long end, std::vector<long long>& samples) {
+        if (options.lookupMode == LookupMode::Plain) {
+            lookupEach(begin, end, samples, [this](int key) { return descend<Rank>(key); });
+        } else {
+            lookupGrouped<Rank>(begin, end, samples);
+        }
+    }
+
+    // Layout index of the first key not below key, or -1. In each node the rank of key picks both the candidate
+    // (if some key there is not below it) and the child; the deepest candidate is the smallest.
+    template <class Rank>
+    long long descend(int key) const {
+        long long nodes = nodeCount();
+        long long found = -1;
+        for (long long k = 0; k < nodes;) {
+            int i = Rank::rank(layout + k * nodeKeys, key);
+            found = i < nodeKeys ? k * nodeKeys + i : found;
+            k = child(k, i);
+        }
+        return found;
+    }
+
+    // lookupGroup lookups descend one level at a time, each prefetching its next node as soon as it is known, so the
+    // group's misses on a level overlap. A sampled query's latency is its group's time.
+    template <class Rank>
+    void lookupGrouped(long long begin, long long end, std::vector<long long>& samples) {
+        long long nodes = nodeCount();
+        for (long long first = begin; first < end; first += lookupGroup) {
+            int count = static_cast<int>(std::min<long long>(lookupGroup, end - first));
+            bool sampled = (first + latencySampleEvery - 1) / latencySampleEvery * latencySampleEvery < first + count;
+            auto start = sampled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            std::array<long long, lookupGroup> node{};
+            std::array<long long, lookupGroup> found;
+            found.fill(-1);
+            for (bool descending = true; descending;) {
+                descending = false;
+                for (int j = 0; j < count; ++j) {
+                    if (node[j] >= nodes) {
+                        continue; // paths into the partly filled last level are one node longer
+                    }
+                    descending = true;
+                    int i = Rank::rank(layout + node[j] * nodeKeys, queries[first + j]);
+                    found[j] = i < nodeKeys ? node[j] * nodeKeys + i : found[j];
+                    node[j] = child(node[j], i);
+                    __builtin_prefetch(layout + node[j] * nodeKeys);
+                }
+            }
+            for (int j = 0; j < count; ++j) {
+                positions[first + j] = found[j];
+            }
+            if (sampled) {
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+    }
+};
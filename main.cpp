@@ -8,19 +8,40 @@ bool verbose = false;
 bool iterative = false;
 bool jsonOutput = false;
 int testSize = 1;
+AlgorithmOptions options;
 struct AlgorithmType {
     enum Type {
         BUBBLE_SORT,
+        ODD_EVEN_SORT,
         QUICK_SORT,
         MERGE_SORT,
+        POWER_SORT,
         INSERTION_SORT,
+        SHELL_SORT,
+        BINARY_INSERTION_SORT,
         SELECTION_SORT,
+        PARALLEL_SELECTION_SORT,
         HEAP_SORT,
+        TOP_K,
+        PARALLEL_SELECT,
+        EXTERNAL_SORT,
+        RECORD_MERGE_SORT,
+        RECORD_RADIX_SORT,
+        SAMPLE_SORT,
+        RADIX_SORT,
+        COUNTING_SORT,
+        SIMD_SORT,
+        PARALLEL_QUICK_SORT,
+        PDQ_SORT,
         MATRIX_MULTIPLICATION,
         MATRIX_ADDITION,
         MATRIX_TRANSPOSE,
         LINEAR_SEARCH,
         BINARY_SEARCH,
+        EYTZINGER_SEARCH,
+        S_TREE_SEARCH,
+        SPARSE_MATRIX_VECTOR,
+        SPARSE_MATRIX_MULTIPLICATION,
         UNKNOWN
     };
 };
@@ -29,21 +50,69 @@ AlgorithmType::Type getAlgorithmType(const std::string &algorithm) {
     if (algorithm == "bubble_sort") {
         return AlgorithmType::BUBBLE_SORT;
     }
+    if (algorithm == "odd_even_sort") {
+        return AlgorithmType::ODD_EVEN_SORT;
+    }
     if (algorithm == "quick_sort") {
         return AlgorithmType::QUICK_SORT;
     }
+    if (algorithm == "radix_sort") {
+        return AlgorithmType::RADIX_SORT;
+    }
+    if (algorithm == "counting_sort") {
+        return AlgorithmType::COUNTING_SORT;
+    }
+    if (algorithm == "simd_sort") {
+        return AlgorithmType::SIMD_SORT;
+    }
+    if (algorithm == "parallel_quick_sort") {
+        return AlgorithmType::PARALLEL_QUICK_SORT;
+    }
+    if (algorithm == "pdq_sort") {
+        return AlgorithmType::PDQ_SORT;
+    }
     if (algorithm == "merge_sort") {
         return AlgorithmType::MERGE_SORT;
     }
+    if (algorithm == "power_sort") {
+        return AlgorithmType::POWER_SORT;
+    }
     if (algorithm == "insertion_sort") {
         return AlgorithmType::INSERTION_SORT;
     }
+    if (algorithm == "shell_sort") {
+        return AlgorithmType::SHELL_SORT;
+    }
+    if (algorithm == "binary_insertion_sort") {
+        return AlgorithmType::BINARY_INSERTION_SORT;
+    }
     if (algorithm == "selection_sort") {
         return AlgorithmType::SELECTION_SORT;
     }
+    if (algorithm == "parallel_selection_sort") {
+        return AlgorithmType::PARALLEL_SELECTION_SORT;
+    }
     if (algorithm == "heap_sort") {
         return AlgorithmType::HEAP_SORT;
     }
+    if (algorithm == "top_k") {
+        return AlgorithmType::TOP_K;
+    }
+    if (algorithm == "parallel_select") {
+        return AlgorithmType::PARALLEL_SELECT;
+    }
+    if (algorithm == "external_sort") {
+        return AlgorithmType::EXTERNAL_SORT;
+    }
+    if (algorithm == "record_merge_sort") {
+        return AlgorithmType::RECORD_MERGE_SORT;
+    }
+    if (algorithm == "record_radix_sort") {
+        return AlgorithmType::RECORD_RADIX_SORT;
+    }
+    if (algorithm == "sample_sort") {
+        return AlgorithmType::SAMPLE_SORT;
+    }
     if (algorithm == "matrix_multiplication") {
         return AlgorithmType::MATRIX_MULTIPLICATION;
     }
@@ -59,11 +128,24 @@ AlgorithmType::Type getAlgorithmType(const std::string &algorithm) {
     if (algorithm == "binary_search") {
         return AlgorithmType::BINARY_SEARCH;
     }
+    if (algorithm == "eytzinger_search") {
+        return AlgorithmType::EYTZINGER_SEARCH;
+    }
+    if (algorithm == "s_tree_search") {
+        return AlgorithmType::S_TREE_SEARCH;
+    }
+    if (algorithm == "sparse_matrix_vector") {
+        return AlgorithmType::SPARSE_MATRIX_VECTOR;
+    }
+    if (algorithm == "sparse_matrix_multiplication") {
+        return AlgorithmType::SPARSE_MATRIX_MULTIPLICATION;
+    }
     std::cerr << "Unknown algorithm '" << algorithm << "'.\n";
     return AlgorithmType::UNKNOWN;
 }
 
-Measurement selectAlgorithm(const std::string& algorithm, int threadCount, long long dataSize) {
+// Returns nullptr (after reporting it) if the name is unknown
+Algorithm* createAlgorithm(const std::string& algorithm, int threadCount, long long dataSize) {
     Algorithm* algo = nullptr;
 
     AlgorithmType::Type type = getAlgorithmType(algorithm);
@@ -72,21 +154,69 @@ Measurement selectAlgorithm(const std::string& algorithm, int threadCount, long
         case AlgorithmType::BUBBLE_SORT:
             algo = new BubbleSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::ODD_EVEN_SORT:
+            algo = new OddEvenTranspositionSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::QUICK_SORT:
             algo = new QuickSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::RADIX_SORT:
+            algo = new RadixSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::COUNTING_SORT:
+            algo = new CountingSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::SIMD_SORT:
+            algo = new SimdSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::PARALLEL_QUICK_SORT:
+            algo = new ParallelQuickSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::PDQ_SORT:
+            algo = new PdqSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::MERGE_SORT:
             algo = new MergeSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::POWER_SORT:
+            algo = new PowerSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::INSERTION_SORT:
             algo = new InsertionSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::SHELL_SORT:
+            algo = new ShellSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::BINARY_INSERTION_SORT:
+            algo = new BinaryInsertionSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::SELECTION_SORT:
             algo = new SelectionSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::PARALLEL_SELECTION_SORT:
+            algo = new ParallelSelectionSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::HEAP_SORT:
             algo = new HeapSort(threadCount, dataSize, verbose, &iterative);
             break;
+        case AlgorithmType::TOP_K:
+            algo = new TopK(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::PARALLEL_SELECT:
+            algo = new ParallelSelect(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::EXTERNAL_SORT:
+            algo = new ExternalSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::RECORD_MERGE_SORT:
+            algo = new RecordMergeSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::RECORD_RADIX_SORT:
+            algo = new RecordRadixSort(threadCount, dataSize, verbose, &iterative);
+            break;
+        case AlgorithmType::SAMPLE_SORT:
+            algo = new SampleSort(threadCount, dataSize, verbose, &iterative);
+            break;
         case AlgorithmType::MATRIX_MULTIPLICATION:
             algo = new MatrixMultiplication(threadCount, dataSize, verbose);
             break;
@@ -102,12 +232,40 @@ Measurement selectAlgorithm(const std::string& algorithm, int threadCount, long
         case AlgorithmType::BINARY_SEARCH:
             algo = new BinarySearch(threadCount, dataSize, verbose);
             break;
+        case AlgorithmType::EYTZINGER_SEARCH:
+            algo = new EytzingerSearch(threadCount, dataSize, verbose);
+            break;
+        case AlgorithmType::S_TREE_SEARCH:
+            algo = new STreeSearch(threadCount, dataSize, verbose);
+            break;
+        case AlgorithmType::SPARSE_MATRIX_VECTOR:
+            algo = new SparseMatrixVectorMultiplication(threadCount, dataSize, verbose);
+            break;
+        case AlgorithmType::SPARSE_MATRIX_MULTIPLICATION:
+            algo = new SparseMatrixMultiplication(threadCount, dataSize, verbose);
+            break;
         default:
             std::cerr << "Error: Unsupported or unknown algorithm '" << algorithm << "'.\n";
-            return Measurement();
+            return nullptr;
     }
 
-    Measurement result = algo->executeAndMeasure(threadCount, dataSize);
+    algo->setOptions(options);
+    return algo;
+}
+
+Measurement selectAlgorithm(const std::string& algorithm, int threadCount, long long dataSize) {
+    Algorithm* algo = createAlgorithm(algorithm, threadCount, dataSize);
+    if (algo == nullptr) {
+        return Measurement::failed("unknown algorithm '" + algorithm + "'");
+    }
+    Measurement result;
+    try {
+        result = algo->executeAndMeasure(threadCount, dataSize);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << algorithm << " failed: " << e.what() << "\n";
+        delete algo;
+        return Measurement::failed(e.what());
+    }
     if (!jsonOutput) {
         std::cout << result.toString() << std::endl;
     }
@@ -163,6 +321,7 @@ void runAlgorithm(const std::string& algorithm, int fireStart, int fireEnd, int
                 successFullTests++;
             }
             finalResult.duration = finalResult.duration / testSize;
+            finalResult.verificationDuration = finalResult.verificationDuration / testSize;
             // Measurement result = selectAlgorithm(algorithm, numThreads, dataSize);
             // if (result == Measurement()) {
             //     continue;
@@ -202,6 +361,243 @@ void analyzeAlgorithm(const std::string& algorithm) {
     testAlgorithm(algorithm, 0, 4);
 }
 
+// Checks the dataset's header and checksum and makes it the input of later runs; "off" goes back to generated inputs
+bool loadDataset(const std::string& path) {
+    if (path == "off") {
+        options.datasetPath.clear();
+        return true;
+    }
+    try {
+        Dataset dataset(path);
+        if (!dataset.verify()) {
+            std::cerr << "Error: " << path << " fails its checksum.\n";
+            return false;
+        }
+        options.datasetPath = path;
+        if (!jsonOutput) {
+            std::cout << "Loaded " << dataset.count() << " values (" << dataset.rows() << " x " << dataset.columns()
+                      << ") from " << path << ".\n";
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
+}
+
+// Writes the input `algorithm` would generate for 2^log2Size elements to path
+void dumpInput(const std::string& algorithm, int log2Size, const std::string& path) {
+    auto dataSize = static_cast<long long>(pow(2, std::ranges::min(log2Size, 62)));
+    Algorithm* algo = createAlgorithm(algorithm, 1, dataSize);
+    if (algo == nullptr) {
+        return;
+    }
+    try {
+        algo->dumpInput(dataSize, path);
+        if (!jsonOutput) {
+            std::cout << "Wrote the " << algorithm << " input for data size " << dataSize << " to " << path << ".\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+    }
+    delete algo;
+}
+
+// Applies one tunable from AlgorithmOptions; returns false if the name or value is not recognised.
+// Each branch checks the parsed value before storing it, so a rejected value leaves the option unchanged.
+bool applyOption(const std::string& name, const std::string& value) {
+    try {
+        if (name == "load") {
+            return loadDataset(value);
+        }
+        if (name == "density") {
+            double density = std::stod(value);
+            if (density <= 0 || density > 1) {
+                return false;
+            }
+            options.sparseDensity = density;
+            return true;
+        }
+        if (name == "power-law") {
+            double exponent = std::stod(value);
+            if (exponent < 0) {
+                return false;
+            }
+            options.sparsePowerLaw = exponent;
+            return true;
+        }
+        if (name == "freivalds-rounds") {
+            int rounds = std::stoi(value);
+            if (rounds <= 0) {
+                return false;
+            }
+            options.freivaldsRounds = rounds;
+            return true;
+        }
+        if (name == "key-min") {
+            int keyMin = std::stoi(value);
+            if (keyMin > options.sortKeyMax) {
+                return false;
+            }
+            options.sortKeyMin = keyMin;
+            return true;
+        }
+        if (name == "key-max") {
+            int keyMax = std::stoi(value);
+            if (keyMax < options.sortKeyMin) {
+                return false;
+            }
+            options.sortKeyMax = keyMax;
+            return true;
+        }
+        if (name == "simd") {
+            if (value == "auto" || value == "avx512") {
+                options.simdLevel = SimdLevel::Avx512;
+            } else if (value == "avx2") {
+                options.simdLevel = SimdLevel::Avx2;
+            } else if (value == "scalar") {
+                options.simdLevel = SimdLevel::Scalar;
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "heap-arity") {
+            int arity = std::stoi(value);
+            if (arity != 2 && arity != 4 && arity != 8) {
+                return false;
+            }
+            options.heapArity = arity;
+            return true;
+        }
+        if (name == "heap-sift") {
+            if (value != "floyd" && value != "top_down") {
+                return false;
+            }
+            options.floydSift = value == "floyd";
+            return true;
+        }
+        if (name == "shell-gaps") {
+            if (value == "ciura") {
+                options.gapSequence = GapSequence::Ciura;
+            } else if (value == "tokuda") {
+                options.gapSequence = GapSequence::Tokuda;
+            } else if (value == "sedgewick") {
+                options.gapSequence = GapSequence::Sedgewick;
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "distribution") {
+            if (value == "uniform") {
+                options.keyDistribution = KeyDistribution::Uniform;
+            } else if (value == "skewed") {
+                options.keyDistribution = KeyDistribution::Skewed;
+            } else if (value == "nearly_sorted") {
+                options.keyDistribution = KeyDistribution::NearlySorted;
+            } else if (value == "runs") {
+                options.keyDistribution = KeyDistribution::Runs;
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "partition") {
+            if (value != "index" && value != "splitters") {
+                return false;
+            }
+            options.splitterPartition = value == "splitters";
+            return true;
+        }
+        if (name == "merge") {
+            if (value != "buffered" && value != "inplace") {
+                return false;
+            }
+            options.inPlaceMerge = value == "inplace";
+            return true;
+        }
+        if (name == "payload") {
+            int bytes = std::stoi(value);
+            if (bytes < 8 || bytes > 64 || bytes % 8 != 0) {
+                return false;
+            }
+            options.recordPayload = bytes;
+            return true;
+        }
+        if (name == "indirect") {
+            if (value != "true" && value != "false") {
+                return false;
+            }
+            options.recordIndirect = value == "true";
+            return true;
+        }
+        if (name == "k") {
+            // a count, or a percentage of the data size such as 50%
+            if (!value.empty() && value.back() == '%') {
+                double fraction = std::stod(value.substr(0, value.size() - 1)) / 100.0;
+                if (fraction <= 0 || fraction > 1) {
+                    return false;
+                }
+                options.selectFraction = fraction;
+                options.selectCount = 0;
+                return true;
+            }
+            long long count = std::stoll(value);
+            if (count <= 0) {
+                return false;
+            }
+            options.selectCount = count;
+            return true;
+        }
+        if (name == "queries") {
+            long long count = std::stoll(value);
+            if (count < 0) {
+                return false;
+            }
+            options.queryCount = count;
+            return true;
+        }
+        if (name == "lookup") {
+            if (value == "plain") {
+                options.lookupMode = LookupMode::Plain;
+            } else if (value == "prefetch") {
+                options.lookupMode = LookupMode::Prefetch;
+            } else if (value == "interleaved") {
+                options.lookupMode = LookupMode::Interleaved;
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "memory-mb") {
+            long long megabytes = std::stoll(value);
+            if (megabytes <= 0) {
+                return false;
+            }
+            options.externalMemoryMb = megabytes;
+            return true;
+        }
+        if (name == "scratch-dir") {
+            if (!std::filesystem::is_directory(value)) {
+                return false;
+            }
+            options.externalDirectory = value;
+            return true;
+        }
+        if (name == "verify") {
+            if (value != "true" && value != "false") {
+                return false;
+            }
+            options.verifyResults = value == "true";
+            return true;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return false;
+}
+
 void toggleVerbose(bool enableVerbose) {
     verbose = enableVerbose;
     std::cout << "Verbose mode " << (verbose ? "enabled" : "disabled") << ".\n";
@@ -213,6 +609,9 @@ void showHelp() {
     std::cout << "test <algorithm> <fire_start> <fire_end>\n";
     std::cout << "analyze <algorithm>\n";
     std::cout << "verbose <true/false>\n";
+    std::cout << "load <file|off>   (inputs come from a dataset file; off generates them again)\n";
+    std::cout << "dump <algorithm> <data_size> <file>   (writes the input the algorithm generates for 2^data_size)\n";
+    std::cout << "set <option> <value>   (options: density, power-law, freivalds-rounds, verify, key-min, key-max, distribution, partition, merge, simd, heap-arity, heap-sift, shell-gaps, payload, indirect, k, memory-mb, scratch-dir, queries, lookup, load; also accepted as --option=value)\n";
     std::cout << "help\n";
 }
 
@@ -288,6 +687,33 @@ void processCommand(const std::string& commandLine) {
             std::cerr << "Error: Missing parameter for 'verbose' command.\n";
         }
     }
+    else if (command == "set") {
+        std::string name, value;
+        if (ss >> name >> value) {
+            if (!applyOption(name, value)) {
+                std::cerr << "Error: Invalid option '" << name << "' or value '" << value << "'.\n";
+            }
+        } else {
+            std::cerr << "Error: Usage is 'set <option> <value>'.\n";
+        }
+    }
+    else if (command == "load") {
+        std::string path;
+        if (ss >> path) {
+            loadDataset(path);
+        } else {
+            std::cerr << "Error: Usage is 'load <file|off>'.\n";
+        }
+    }
+    else if (command == "dump") {
+        std::string algorithm, path;
+        int size;
+        if (ss >> algorithm >> size >> path && isValidPositive(size)) {
+            dumpInput(algorithm, size, path);
+        } else {
+            std::cerr << "Error: Usage is 'dump <algorithm> <data_size> <file>'.\n";
+        }
+    }
     else if (command == "help") {
         showHelp();
     } else if (command == "json_output") {
@@ -330,22 +756,27 @@ int main_infinite() {
 
 int main(int argc, char* argv[]) {
     if (argc > 1) {
+        jsonOutput = true; // set before the options are applied so that they print nothing besides the JSON
         std::string commandLine;
         for (int i = 1; i < argc; ++i) {
             commandLine += argv[i];
             if (i < argc - 1) {
                 commandLine += " ";
             }
-            if (argv[i] == "--use-iterative") {
+            if (std::string(argv[i]) == "--use-iterative") {
                 iterative = true;
             }
             // --repeat=INT is used to repeat the test INT times
             if (std::string(argv[i]).find("--repeat=") != std::string::npos) {
                 std::string repeat = std::string(argv[i]).substr(9);
                 testSize = std::stoi(repeat);
+            } else if (std::string argument(argv[i]); argument.starts_with("--") && argument.find('=') != std::string::npos) {
+                auto separator = argument.find('=');
+                if (!applyOption(argument.substr(2, separator - 2), argument.substr(separator + 1))) {
+                    std::cerr << "Error: Invalid option '" << argument << "'.\n";
+                }
             }
         }
-        jsonOutput = true;
         // check at the end if the command is iterative by checking if the last word is --use-iterative
         if (commandLine.find("--use-iterative") != std::string::npos) {
             iterative = true;